@@ -0,0 +1,464 @@
+#include "harness.hpp"
+
+using namespace raz;
+using bench::do_not_optimize;
+
+static const char* io_path = "target/bench_io.txt";
+static const u32 io_lines = 200000;
+
+static void bench_string(bench::runner& r) {
+    string chunk("0123456789");
+    r.run("string/append 10B x100", 100, [&] {
+        string s;
+        for(u32 i = 0; i < 100; i++) s.append(chunk);
+        do_not_optimize(s);
+    });
+    r.run("string/push_back x100", 100, [&] {
+        string s;
+        for(u32 i = 0; i < 100; i++) s.push_back('x');
+        do_not_optimize(s);
+    });
+
+    string a, b;
+    for(u32 i = 0; i < 256; i++) {
+        a.push_back((char)('a' + i % 26));
+        b.push_back((char)('a' + i % 26));
+    }
+    b[255] = '!';
+    r.run("string/== 256B", 256, [&] {
+        bool same = a == b;
+        do_not_optimize(same);
+    });
+    r.run("string/compare 256B", 256, [&] {
+        i32 c = a.compare(b);
+        do_not_optimize(c);
+    });
+    r.run("string/substr 16B", 1, [&] {
+        string s = a.substr(100, 16);
+        do_not_optimize(s);
+    });
+    r.run("string/substr 64B", 1, [&] {
+        string s = a.substr(100, 64);
+        do_not_optimize(s);
+    });
+    r.run("string/find 256B", 256, [&] {
+        i32 at = b.find("yz!");
+        do_not_optimize(at);
+    });
+    r.run("string_view/split 256B", 256, [&] {
+        u32 pieces = 0;
+        for(string_view piece : a.view().split('e')) pieces += piece.length();
+        do_not_optimize(pieces);
+    });
+}
+
+static void bench_vector(bench::runner& r) {
+    static const u32 sizes[] = {16, 1024, 65536};
+    for(u32 n : sizes) {
+        string name = format("vector/push_back growth {}", n);
+        r.run(name.c_str(), n, [&] {
+            vector<u32> v;
+            for(u32 i = 0; i < n; i++) v.push_back(i);
+            do_not_optimize(v.begin());
+        });
+        name = format("vector/push_back reserved {}", n);
+        r.run(name.c_str(), n, [&] {
+            vector<u32> v;
+            v.reserve(n);
+            for(u32 i = 0; i < n; i++) v.push_back(i);
+            do_not_optimize(v.begin());
+        });
+    }
+    r.run("vector/push_back 6", 6, [&] {
+        vector<u32> v;
+        for(u32 i = 0; i < 6; i++) v.push_back(i);
+        do_not_optimize(v.begin());
+    });
+    r.run("small_vector<8>/push_back 6", 6, [&] {
+        small_vector<u32, 8> v;
+        for(u32 i = 0; i < 6; i++) v.push_back(i);
+        do_not_optimize(v.begin());
+    });
+    r.run("static_vector<8>/push_back 6", 6, [&] {
+        static_vector<u32, 8> v;
+        for(u32 i = 0; i < 6; i++) v.push_back(i);
+        do_not_optimize(v.begin());
+    });
+    r.run("vector<string>/push_back 1024", 1024, [&] {
+        vector<string> v;
+        for(u32 i = 0; i < 1024; i++) v.push_back(string("a moderately long string value"));
+        do_not_optimize(v.begin());
+    });
+}
+
+static void bench_map(bench::runner& r) {
+    static const u32 sizes[] = {16, 256, 4096};
+    for(u32 n : sizes) {
+        string name = format("map/insert {}", n);
+        r.run(name.c_str(), n, [&] {
+            map<u32, u32> m;
+            for(u32 i = 0; i < n; i++) m.insert(i * 7919, i);
+            do_not_optimize(m);
+        });
+
+        map<u32, u32> m;
+        for(u32 i = 0; i < n; i++) m.insert(i * 7919, i);
+        u32 k = 0;
+        name = format("map/get {}", n);
+        r.run(name.c_str(), 1, [&] {
+            optional<u32> v = m.get((k++ % n) * 7919);
+            do_not_optimize(v);
+        });
+
+        name = format("hash_map/insert {}", n);
+        r.run(name.c_str(), n, [&] {
+            hash_map<u32, u32> h;
+            for(u32 i = 0; i < n; i++) h.insert(i * 7919, i);
+            do_not_optimize(h);
+        });
+
+        hash_map<u32, u32> h;
+        for(u32 i = 0; i < n; i++) h.insert(i * 7919, i);
+        name = format("hash_map/get {}", n);
+        r.run(name.c_str(), 1, [&] {
+            optional<u32> v = h.get((k++ % n) * 7919);
+            do_not_optimize(v);
+        });
+    }
+
+    hash_map<string, u32> words;
+    vector<string> keys;
+    for(u32 i = 0; i < 4096; i++) {
+        keys.push_back(format("key_{}_{}", i, i * 31));
+        words.insert(keys[i], i);
+    }
+    u32 k = 0;
+    r.run("hash_map<string>/get 4096", 1, [&] {
+        u32* v = words.find(keys[k++ & 4095]);
+        do_not_optimize(v);
+    });
+
+    static constexpr auto commands = make_frozen_map<u32>({
+        {"add", 0}, {"list", 1}, {"remove", 2}, {"rename", 3}, {"show", 4}, {"status", 5},
+        {"commit", 6}, {"push", 7}, {"pull", 8}, {"fetch", 9}, {"merge", 10}, {"rebase", 11},
+        {"log", 12}, {"diff", 13}, {"help", 14}, {"version", 15}
+    });
+    hash_map<string_view, u32> command_hash;
+    map<string, u32> command_map;
+    for(const auto& c : commands) {
+        command_hash.insert(c.first, c.second);
+        command_map.insert(string(c.first), c.second);
+    }
+    r.run("frozen_map/find 16 commands", 1, [&] {
+        const u32* v = commands.find(commands.begin()[k++ & 15].first);
+        do_not_optimize(v);
+    });
+    r.run("hash_map<string_view>/find 16 commands", 1, [&] {
+        u32* v = command_hash.find(commands.begin()[k++ & 15].first);
+        do_not_optimize(v);
+    });
+    r.run("map<string>/get 16 commands", 1, [&] {
+        optional<u32> v = command_map.get(string(commands.begin()[k++ & 15].first));
+        do_not_optimize(v);
+    });
+}
+
+static void bench_sort(bench::runner& r) {
+    static const u32 n = 100000;
+    vector<u32> input(n);
+    raz::random rng(7);
+    for(u32 i = 0; i < n; i++) input[i] = rng.next();
+    vector<u32> work;
+
+    auto reset = [&] { work = input; };
+    r.run_setup("sort/pdqsort 100k u32", n, reset, [&] { sort(work); });
+    r.run_setup("sort/stable_sort 100k u32", n, reset, [&] { stable_sort(work); });
+    r.run_setup("sort/radix_sort 100k u32", n, reset, [&] { radix_sort(work.begin(), work.size()); });
+    r.run_setup("sort/parallel_sort 100k u32", n, reset, [&] { parallel_sort(work); });
+    r.run_setup("sort/pdqsort sorted 100k", n, [&] { work = input; sort(work); }, [&] { sort(work); });
+
+    vector<f64> reals(n);
+    for(u32 i = 0; i < n; i++) reals[i] = rng.next_f64();
+    vector<f64> real_work;
+    r.run_setup("sort/pdqsort 100k f64", n, [&] { real_work = reals; }, [&] { sort(real_work); });
+}
+
+static void bench_queue(bench::runner& r) {
+    r.run("queue/push+pop 1024", 1024, [&] {
+        queue<u32> q;
+        for(u32 i = 0; i < 1024; i++) q.push(i);
+        u32 sum = 0;
+        for(u32 i = 0; i < 1024; i++) {
+            sum += q.front();
+            q.pop();
+        }
+        do_not_optimize(sum);
+    });
+
+    queue<u32> steady;
+    for(u32 i = 0; i < 64; i++) steady.push(i);
+    r.run("queue/steady push+pop", 1, [&] {
+        steady.push(steady.front());
+        steady.pop();
+    });
+
+    static spsc_queue<u32, 1024> spsc;
+    r.run("spsc_queue/push+pop 1024", 1024, [&] {
+        for(u32 i = 0; i < 1024; i++) spsc.push(i);
+        u32 sum = 0, v = 0;
+        while(spsc.pop(v)) sum += v;
+        do_not_optimize(sum);
+    });
+
+    mpmc_queue<u32> mpmc(1024);
+    r.run("mpmc_queue/push+pop 1024", 1024, [&] {
+        for(u32 i = 0; i < 1024; i++) mpmc.push(i);
+        u32 sum = 0, v = 0;
+        while(mpmc.pop(v)) sum += v;
+        do_not_optimize(sum);
+    });
+
+    r.run("deque/push_front+pop_back 1024", 1024, [&] {
+        deque<u32> d;
+        for(u32 i = 0; i < 1024; i++) d.push_front(i);
+        while(!d.empty()) d.pop_back();
+        do_not_optimize(d);
+    });
+}
+
+static void bench_random(bench::runner& r) {
+    raz::random rng(1);
+    r.run("random/next", 1, [&] {
+        u32 v = rng.next();
+        do_not_optimize(v);
+    });
+    r.run("random/range 1..6", 1, [&] {
+        u32 v = rng.range(1, 6);
+        do_not_optimize(v);
+    });
+    r.run("random/next_f64", 1, [&] {
+        f64 v = rng.next_f64();
+        do_not_optimize(v);
+    });
+    static u64 block[4096];
+    r.run("random/fill 4096 u64", 4096, [&] {
+        rng.fill(block, 4096);
+        do_not_optimize(block[0]);
+    });
+    random_pcg pcg;
+    r.run("random_pcg/next", 1, [&] {
+        u64 v = pcg.next_u64();
+        do_not_optimize(v);
+    });
+}
+
+static void bench_bitset(bench::runner& r) {
+    static const u32 bits = 1u << 20;
+    dynamic_bitset<> a(bits), b(bits);
+    vector<u8> flags_a(bits), flags_b(bits);
+    raz::random rng(7);
+    for(u32 i = 0; i < bits; i++) {
+        if(rng.next() % 3 == 0) { a.set(i); flags_a[i] = 1; }
+        if(rng.next() % 2 == 0) { b.set(i); flags_b[i] = 1; }
+    }
+
+    r.run("vector<u8>/and 1M flags", bits, [&] {
+        for(u32 i = 0; i < bits; i++) flags_a[i] &= flags_b[i];
+        do_not_optimize(flags_a.begin());
+    });
+    r.run("dynamic_bitset/and 1M bits", bits, [&] {
+        a &= b;
+        do_not_optimize(a.words());
+    });
+    r.run("vector<u8>/count 1M flags", bits, [&] {
+        u32 n = 0;
+        for(u32 i = 0; i < bits; i++) n += flags_a[i];
+        do_not_optimize(n);
+    });
+    r.run("dynamic_bitset/count 1M bits", bits, [&] {
+        u32 n = a.count();
+        do_not_optimize(n);
+    });
+
+    dynamic_bitset<> sparse(bits);
+    for(u32 i = 0; i < bits; i += 4099) sparse.set(i);
+    r.run("dynamic_bitset/find_next sparse 1M", bits, [&] {
+        u32 n = 0;
+        for(i32 i = sparse.find_first(); i >= 0; i = sparse.find_next(i + 1)) n++;
+        do_not_optimize(n);
+    });
+
+    rank_index<> index(a);
+    u32 k = 0;
+    r.run("dynamic_bitset/rank 1M", 1, [&] {
+        u32 n = a.rank((k += 7919) & (bits - 1));
+        do_not_optimize(n);
+    });
+    r.run("rank_index/rank 1M", 1, [&] {
+        u32 n = index.rank((k += 7919) & (bits - 1));
+        do_not_optimize(n);
+    });
+    r.run("rank_index/select 1M", 1, [&] {
+        i32 n = index.select((k += 7919) % index.ones());
+        do_not_optimize(n);
+    });
+}
+
+static void bench_hash(bench::runner& r) {
+    static char text[4097];
+    for(u32 i = 0; i < 4096; i++) text[i] = (char)('a' + i % 26);
+    text[4096] = '\0';
+    static char word[17] = "abcdefghijklmnop";
+
+    r.run("hash_simple 16B", 16, [&] {
+        u32 h = hash_simple(word);
+        do_not_optimize(h);
+    });
+    r.run("hash_simple 4KB", 4096, [&] {
+        u32 h = hash_simple(text);
+        do_not_optimize(h);
+    });
+    r.run("hash_bytes 16B", 16, [&] {
+        u64 h = hash_bytes(word, 16);
+        do_not_optimize(h);
+    });
+    r.run("hash_bytes 4KB", 4096, [&] {
+        u64 h = hash_bytes(text, 4096);
+        do_not_optimize(h);
+    });
+    u64 x = 0;
+    r.run("hash<u64>", 1, [&] {
+        u64 h = hash<u64>()(x++);
+        do_not_optimize(h);
+    });
+}
+
+static void write_io_file() {
+    i32 fd = sys::open(io_path, sys::o_wronly | sys::o_creat | sys::o_trunc);
+    {
+        ostream out(fd);
+        for(u32 i = 0; i < io_lines; i++) out << "value " << (i32)(i * 2654435761u) << " " << (f64)i * 0.25 << "\n";
+    }
+    sys::close(fd);
+}
+
+// Output that ends exactly on a buffer boundary must reach the file on both
+// the io_uring and the writev path. Returns false (and says so) otherwise.
+static bool check_async_writer() {
+    bool ok = true;
+    for(u32 ring = 0; ring < 2; ring++) {
+        for(u32 buffers = 1; buffers <= 3; buffers++) {
+            i32 fd = sys::open(io_path, sys::o_wronly | sys::o_creat | sys::o_trunc);
+            {
+                async_writer out(fd, 2, 4096, ring == 1);
+                for(u32 i = 0; i < buffers * 4096; i++) out << 'x';
+            }
+            sys::close(fd);
+            mapped_file file(io_path);
+            if(file.size() != buffers * 4096) {
+                println_fmt("async_writer check failed: ring={} wrote {} found {}", ring, buffers * 4096, file.size());
+                ok = false;
+            }
+        }
+        // O_APPEND is not seekable: buffers queue behind one write in flight.
+        i32 fd = sys::open(io_path, sys::o_wronly | sys::o_creat | sys::o_trunc | sys::o_append);
+        {
+            async_writer out(fd, 2, 4096, ring == 1);
+            for(u32 i = 0; i < 8 * 4096; i++) out << (char)('a' + i / 4096);
+        }
+        sys::close(fd);
+        mapped_file file(io_path);
+        bool ordered = file.size() == 8 * 4096;
+        for(u32 i = 0; ordered && i < 8 * 4096; i++) ordered = file.data()[i] == (char)('a' + i / 4096);
+        if(!ordered) {
+            println_fmt("async_writer check failed: ring={} appended buffers out of order", ring);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static void bench_io(bench::runner& r) {
+    r.run_setup("ostream/write ints+text to file", io_lines, [] {}, write_io_file);
+
+    r.run_setup("ostream/format_to to file", io_lines, [] {}, [] {
+        i32 fd = sys::open(io_path, sys::o_wronly | sys::o_creat | sys::o_trunc);
+        {
+            ostream out(fd);
+            char line[64];
+            for(u32 i = 0; i < io_lines; i++) {
+                u32 n = format_to(line, sizeof(line), "value {} {}\n", (i32)(i * 2654435761u), (f64)i * 0.25);
+                out << string_view(line, n);
+            }
+        }
+        sys::close(fd);
+    });
+
+    r.run_setup("async_writer/write ints+text to file", io_lines, [] {}, [] {
+        i32 fd = sys::open(io_path, sys::o_wronly | sys::o_creat | sys::o_trunc);
+        {
+            async_writer out(fd, 4);
+            for(u32 i = 0; i < io_lines; i++) out << "value " << (i32)(i * 2654435761u) << " " << (f64)i * 0.25 << "\n";
+        }
+        sys::close(fd);
+    });
+
+    // istream carries its 64KB buffer inline, so it lives in static storage and
+    // is re-constructed over a freshly opened descriptor before every sample.
+    static istream* in = nullptr;
+    static char in_storage[sizeof(istream)] __attribute__((aligned(16)));
+    static i32 in_fd = -1;
+    write_io_file();
+    auto reopen = [] {
+        if(in_fd >= 0) sys::close(in_fd);
+        in_fd = sys::open(io_path, sys::o_rdonly);
+        in = new(in_storage) istream(in_fd);
+    };
+    r.run_setup("istream/read ints+text from file", io_lines, reopen, [] {
+        string word;
+        i32 value;
+        f64 real;
+        f64 sum = 0;
+        while(*in >> word >> value >> real) sum += real + value;
+        do_not_optimize(sum);
+    });
+
+    r.run_setup("istream/getline from file", io_lines, reopen, [] {
+        string line;
+        u64 total = 0;
+        while(in->getline(line)) total += line.length();
+        do_not_optimize(total);
+    });
+    if(in_fd >= 0) sys::close(in_fd);
+
+    mapped_file mapped(io_path);
+    r.run("mapped_file/lines", io_lines, [&] {
+        u64 total = 0;
+        for(string_view line : mapped.lines()) total += line.length();
+        do_not_optimize(total);
+    });
+    r.run("mapped_file/lines+parse", io_lines, [&] {
+        f64 sum = 0;
+        for(string_view line : mapped.lines()) {
+            i32 space = line.rfind(' ');
+            sum += line.substr(space + 1).parse<f64>().value;
+        }
+        do_not_optimize(sum);
+    });
+}
+
+int main(int argc, char** argv) {
+    bench::options opts;
+    if(argc > 1) opts.filter = argv[1];
+    bench::runner r(opts);
+    bench_string(r);
+    bench_vector(r);
+    bench_map(r);
+    bench_sort(r);
+    bench_queue(r);
+    bench_random(r);
+    bench_bitset(r);
+    bench_hash(r);
+    bench_io(r);
+    return check_async_writer() ? 0 : 1;
+}
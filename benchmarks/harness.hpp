@@ -0,0 +1,145 @@
+#ifndef RAZ_BENCH_HARNESS_HPP
+#define RAZ_BENCH_HARNESS_HPP
+
+#include "../raz.hpp"
+
+// Minimal freestanding micro-benchmark harness: no libc, timing through rdtsc
+// (calibrated against CLOCK_MONOTONIC) or the raw clock_gettime syscall.
+
+namespace bench {
+
+using raz::u32;
+using raz::u64;
+using raz::f64;
+
+// Objects wider than a register can only be named as memory operands; GCC
+// rejects a register alternative for them at -O3.
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    if constexpr(sizeof(T) <= sizeof(void*)) asm volatile("" : : "r,m"(value) : "memory");
+    else asm volatile("" : : "m"(value) : "memory");
+}
+
+template<typename T>
+inline void do_not_optimize(T& value) {
+    if constexpr(sizeof(T) <= sizeof(void*)) asm volatile("" : "+m,r"(value) : : "memory");
+    else asm volatile("" : "+m"(value) : : "memory");
+}
+
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+inline u64 ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    u32 lo, hi;
+    asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((u64)hi << 32) | lo;
+#else
+    return raz::sys::monotonic_ns();
+#endif
+}
+
+struct options {
+    u32 warmup = 5;
+    u32 samples = 51;
+    f64 min_sample_ns = 200000.0;
+    const char* filter = nullptr;
+};
+
+class runner {
+private:
+    options opts;
+    f64 ns_per_tick;
+    u32 ran;
+
+    void calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+        u64 t0 = raz::sys::monotonic_ns();
+        u64 c0 = ticks();
+        while(raz::sys::monotonic_ns() - t0 < 20000000ULL) {}
+        u64 t1 = raz::sys::monotonic_ns();
+        u64 c1 = ticks();
+        ns_per_tick = (f64)(t1 - t0) / (f64)(c1 - c0);
+#else
+        ns_per_tick = 1.0;
+#endif
+    }
+
+    bool selected(const char* name) const {
+        return opts.filter == nullptr || raz::string_view(name).contains(opts.filter);
+    }
+
+    void report(const char* name, u64 items, raz::vector<f64>& per_op) {
+        raz::sort(per_op);
+        u32 n = per_op.size();
+        f64 median = per_op[n / 2];
+        u32 p99_index = (u32)(0.99 * (n - 1) + 0.5);
+        f64 p99 = per_op[p99_index];
+        raz::println_fmt("{:<36} {:>12.1f} {:>12.1f} {:>10.2f}", name, median, p99, median / (f64)items);
+        ran++;
+    }
+
+public:
+    runner(const options& o = options()) : opts(o), ns_per_tick(1.0), ran(0) {
+        calibrate();
+        raz::println_fmt("{:<36} {:>12} {:>12} {:>10}", "benchmark", "median ns", "p99 ns", "ns/item");
+    }
+
+    ~runner() {
+        raz::println_fmt("{} benchmarks", ran);
+    }
+
+    // Times `body` in batches sized so one sample lasts at least
+    // `min_sample_ns`; reports per-call figures.
+    template<typename F>
+    void run(const char* name, u64 items, F body) {
+        if(!selected(name)) return;
+        u64 iters = 1;
+        while(true) {
+            u64 start = ticks();
+            for(u64 i = 0; i < iters; i++) body();
+            f64 ns = (f64)(ticks() - start) * ns_per_tick;
+            if(ns >= opts.min_sample_ns || iters >= (1ULL << 30)) break;
+            u64 scale = ns > 0 ? (u64)(opts.min_sample_ns / ns * 1.2) + 1 : 16;
+            iters *= scale < 2 ? 2 : scale > 16 ? 16 : scale;
+        }
+        for(u32 w = 0; w < opts.warmup; w++) {
+            for(u64 i = 0; i < iters; i++) body();
+        }
+        raz::vector<f64> per_op;
+        per_op.reserve(opts.samples);
+        for(u32 s = 0; s < opts.samples; s++) {
+            u64 start = ticks();
+            for(u64 i = 0; i < iters; i++) body();
+            per_op.push_back((f64)(ticks() - start) * ns_per_tick / (f64)iters);
+        }
+        report(name, items, per_op);
+    }
+
+    // For operations that consume their input: `setup` runs untimed before
+    // every single timed call of `body`.
+    template<typename S, typename F>
+    void run_setup(const char* name, u64 items, S setup, F body) {
+        if(!selected(name)) return;
+        for(u32 w = 0; w < opts.warmup; w++) {
+            setup();
+            body();
+        }
+        raz::vector<f64> per_op;
+        per_op.reserve(opts.samples);
+        for(u32 s = 0; s < opts.samples; s++) {
+            setup();
+            clobber_memory();
+            u64 start = ticks();
+            body();
+            clobber_memory();
+            per_op.push_back((f64)(ticks() - start) * ns_per_tick);
+        }
+        report(name, items, per_op);
+    }
+};
+
+}
+
+#endif
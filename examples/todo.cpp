@@ -1,5 +1,13 @@
 #include "../raz.hpp"
 
+enum class action { add, view, exit };
+
+constexpr auto actions = raz::make_frozen_map<action>({
+    {"1", action::add}, {"add", action::add},
+    {"2", action::view}, {"view", action::view},
+    {"3", action::exit}, {"exit", action::exit}
+});
+
 int main() {
     raz::vector<raz::string> tasks;
     
@@ -7,19 +15,21 @@ int main() {
     
     while(true) {
         raz::string option = raz::input("\n1. Add task\n2. View tasks\n3. Exit\nOption: ");
+        const action* chosen = actions.find(option);
+        if(!chosen) continue;
         
-        if(option == "1") {
+        if(*chosen == action::add) {
             raz::string task = raz::input("Task: ");
             tasks.push_back(task);
             raz::println("Task added!");
         }
-        else if(option == "2") {
+        else if(*chosen == action::view) {
             raz::println("\n--- Your tasks ---");
             for(raz::u32 i = 0; i < tasks.size(); i++) {
                 raz::cout << (i + 1) << ". " << tasks[i] << raz::endl;
             }
         }
-        else if(option == "3") {
+        else if(*chosen == action::exit) {
             break;
         }
     }
@@ -2,6 +2,30 @@
 #define RAZ_HPP
 
 #include <initializer_list>
+#include <new>
+
+#if !defined(RAZ_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define RAZ_SIMD_AVX2 1
+#elif !defined(RAZ_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define RAZ_SIMD_SSE2 1
+#elif !defined(RAZ_NO_SIMD) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RAZ_SIMD_NEON 1
+#endif
+
+#if defined(__GNUC__)
+#define RAZ_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define RAZ_NO_SANITIZE_ADDRESS
+#endif
+
+#if defined(__cpp_consteval)
+#define RAZ_CONSTEVAL consteval
+#else
+#define RAZ_CONSTEVAL constexpr
+#endif
 
 namespace raz {
 
@@ -19,18 +43,60 @@ using f32 = float;
 using f64 = double;
 using byte = unsigned char;
 
-class string;
+template<typename A> class basic_string;
+template<typename T> struct parse_result;
 
 struct endl_t {};
 static constexpr endl_t endl;
 
+template<typename T> struct remove_reference { using type = T; };
+template<typename T> struct remove_reference<T&> { using type = T; };
+template<typename T> struct remove_reference<T&&> { using type = T; };
+
+template<typename T> struct type_identity { using type = T; };
+
+template<typename T>
+constexpr typename remove_reference<T>::type&& move(T&& value) {
+    return static_cast<typename remove_reference<T>::type&&>(value);
+}
+
+template<typename T>
+constexpr T&& forward(typename remove_reference<T>::type& value) {
+    return static_cast<T&&>(value);
+}
+
+template<typename T>
+constexpr T&& forward(typename remove_reference<T>::type&& value) {
+    return static_cast<T&&>(value);
+}
+
+template<typename T>
+struct is_trivially_copyable {
+    static constexpr bool value = __is_trivially_copyable(T);
+};
+
+template<typename T>
+struct is_trivial {
+    static constexpr bool value = __is_trivial(T);
+};
+
+template<typename T>
+void swap(T& a, T& b) {
+    T temp = move(a);
+    a = move(b);
+    b = move(temp);
+}
+
 template<typename T, typename U>
 struct pair {
     T first;
     U second;
     
-    pair() : first(), second() {}
-    pair(const T& f, const U& s) : first(f), second(s) {}
+    constexpr pair() : first(), second() {}
+    constexpr pair(const T& f, const U& s) : first(f), second(s) {}
+
+    bool operator==(const pair& other) const { return first == other.first && second == other.second; }
+    bool operator!=(const pair& other) const { return !(*this == other); }
 };
 
 template<typename T, typename U>
@@ -57,718 +123,8276 @@ public:
     }
 };
 
+void memcpy_simple(void* dest, const void* src, u32 n) {
+    #if defined(__GNUC__)
+    __builtin_memcpy(dest, src, n);
+    #else
+    char* d = (char*)dest;
+    const char* s = (const char*)src;
+    for(u32 i = 0; i < n; i++) d[i] = s[i];
+    #endif
+}
+
+namespace detail {
+
+// Byte-mask kernels. Each returns a mask with `simd_bits` bits per input byte
+// (lowest byte first) set where the predicate holds. They are exempt from ASan
+// because strlen/strcmp deliberately read whole blocks past the terminator.
+using simd_mask = u64;
+
+// Hides the pointer's provenance from the optimizer so those intentional
+// over-reads of small arrays do not trigger -Warray-bounds.
+inline const char* opaque(const char* p) {
+    __asm__("" : "+r"(p));
+    return p;
+}
+
+#if defined(RAZ_SIMD_AVX2)
+static constexpr u32 simd_width = 32;
+static constexpr u32 simd_bits = 1;
+static constexpr simd_mask simd_full = 0xFFFFFFFFULL;
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_zero(const char* p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)opaque(p));
+    return (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+}
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_eq(const char* a, const char* b) {
+    __m256i va = _mm256_loadu_si256((const __m256i*)opaque(a));
+    __m256i vb = _mm256_loadu_si256((const __m256i*)opaque(b));
+    return (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+}
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_byte(const char* p, char c) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)opaque(p));
+    return (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+}
+#elif defined(RAZ_SIMD_SSE2)
+static constexpr u32 simd_width = 16;
+static constexpr u32 simd_bits = 1;
+static constexpr simd_mask simd_full = 0xFFFFULL;
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_zero(const char* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*)opaque(p));
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+}
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_eq(const char* a, const char* b) {
+    __m128i va = _mm_loadu_si128((const __m128i*)opaque(a));
+    __m128i vb = _mm_loadu_si128((const __m128i*)opaque(b));
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+}
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_byte(const char* p, char c) {
+    __m128i v = _mm_loadu_si128((const __m128i*)opaque(p));
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+}
+#elif defined(RAZ_SIMD_NEON)
+static constexpr u32 simd_width = 16;
+static constexpr u32 simd_bits = 4;
+static constexpr simd_mask simd_full = ~0ULL;
+
+inline simd_mask neon_mask(uint8x16_t cmp) {
+    uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+}
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_zero(const char* p) {
+    return neon_mask(vceqq_u8(vld1q_u8((const u8*)opaque(p)), vdupq_n_u8(0)));
+}
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_eq(const char* a, const char* b) {
+    return neon_mask(vceqq_u8(vld1q_u8((const u8*)opaque(a)), vld1q_u8((const u8*)opaque(b))));
+}
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_byte(const char* p, char c) {
+    return neon_mask(vceqq_u8(vld1q_u8((const u8*)opaque(p)), vdupq_n_u8((u8)c)));
+}
+#else
+static constexpr u32 simd_width = 8;
+static constexpr u32 simd_bits = 8;
+static constexpr simd_mask simd_full = 0x8080808080808080ULL;
+
+using unaligned_u64 = u64 __attribute__((may_alias, aligned(1)));
+
+RAZ_NO_SANITIZE_ADDRESS inline u64 load_word(const char* p) {
+    return *(const unaligned_u64*)opaque(p);
+}
+
+// Exact zero-byte detection (no false positives from borrows).
+inline simd_mask swar_zero(u64 w) {
+    const u64 low7 = 0x7F7F7F7F7F7F7F7FULL;
+    return ~(((w & low7) + low7) | w | low7);
+}
+
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_zero(const char* p) { return swar_zero(load_word(p)); }
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_eq(const char* a, const char* b) { return swar_zero(load_word(a) ^ load_word(b)); }
+RAZ_NO_SANITIZE_ADDRESS inline simd_mask mask_byte(const char* p, char c) { return swar_zero(load_word(p) ^ (0x0101010101010101ULL * (u8)c)); }
+#endif
+
+static constexpr simd_mask simd_lane = simd_bits == 8 ? 0x80 : (1ULL << simd_bits) - 1;
+
+inline u32 first_lane(simd_mask m) {
+    return (u32)__builtin_ctzll(m) / simd_bits;
+}
+
+inline bool page_safe(const char* p) {
+    return ((u64)p & 4095) <= 4096 - simd_width;
+}
+
+}
+
+// Reads whole aligned blocks, which may extend past the terminator but never
+// cross into the next page.
+RAZ_NO_SANITIZE_ADDRESS
 u32 strlen_simple(const char* str) {
-    u32 len = 0;
-    while(str[len] != '\0') len++;
-    return len;
+    using namespace detail;
+    u32 misalign = (u32)((u64)str & (simd_width - 1));
+    const char* block = str - misalign;
+    simd_mask m = mask_zero(block) >> (misalign * simd_bits);
+    if(m) return first_lane(m);
+    while(true) {
+        block += simd_width;
+        m = mask_zero(block);
+        if(m) return (u32)(block - str) + first_lane(m);
+    }
 }
 
-void strcpy_simple(char* dest, const char* src) {
+bool memeq_simple(const void* a, const void* b, u32 n) {
+    using namespace detail;
+    const char* pa = (const char*)a;
+    const char* pb = (const char*)b;
     u32 i = 0;
-    while(src[i] != '\0') {
-        dest[i] = src[i];
-        i++;
+    for(; i + simd_width <= n; i += simd_width) {
+        if(mask_eq(pa + i, pb + i) != simd_full) return false;
     }
-    dest[i] = '\0';
+    if(i == n) return true;
+    if(n >= simd_width) return mask_eq(pa + n - simd_width, pb + n - simd_width) == simd_full;
+    for(; i < n; i++) {
+        if(pa[i] != pb[i]) return false;
+    }
+    return true;
 }
 
-i32 strcmp_simple(const char* a, const char* b) {
+i32 memcmp_simple(const void* a, const void* b, u32 n) {
+    using namespace detail;
+    const u8* pa = (const u8*)a;
+    const u8* pb = (const u8*)b;
     u32 i = 0;
-    while(a[i] != '\0' && b[i] != '\0') {
-        if(a[i] != b[i]) return a[i] - b[i];
-        i++;
+    for(; i + simd_width <= n; i += simd_width) {
+        simd_mask diff = ~mask_eq((const char*)pa + i, (const char*)pb + i) & simd_full;
+        if(diff) {
+            u32 at = i + first_lane(diff);
+            return (i32)pa[at] - (i32)pb[at];
+        }
     }
-    return a[i] - b[i];
+    for(; i < n; i++) {
+        if(pa[i] != pb[i]) return (i32)pa[i] - (i32)pb[i];
+    }
+    return 0;
 }
 
-class string {
-private:
-    char* data;
-    u32 len;
-    u32 cap;
-
-    void resize(u32 new_cap) {
-        char* new_data = new char[new_cap];
-        for(u32 i = 0; i < len; i++) {
-            new_data[i] = data[i];
+RAZ_NO_SANITIZE_ADDRESS
+i32 strcmp_simple(const char* a, const char* b) {
+    using namespace detail;
+    const u8* pa = (const u8*)a;
+    const u8* pb = (const u8*)b;
+    u32 i = 0;
+    while(true) {
+        if(page_safe(a + i) && page_safe(b + i)) {
+            simd_mask stop = (~mask_eq(a + i, b + i) & simd_full) | mask_zero(a + i);
+            if(stop) {
+                u32 at = i + first_lane(stop);
+                return (i32)pa[at] - (i32)pb[at];
+            }
+            i += simd_width;
+        } else {
+            for(u32 k = 0; k < simd_width; k++, i++) {
+                if(pa[i] != pb[i] || pa[i] == 0) return (i32)pa[i] - (i32)pb[i];
+            }
         }
-        delete[] data;
-        data = new_data;
-        cap = new_cap;
     }
+}
 
-public:
-    string() : data(new char[16]), len(0), cap(16) {
-        data[0] = '\0';
-    }
+void strcpy_simple(char* dest, const char* src) {
+    memcpy_simple(dest, src, strlen_simple(src) + 1);
+}
 
-    string(const char* str) {
-        len = strlen_simple(str);
-        cap = len + 1;
-        if(cap < 16) cap = 16;
-        
-        data = new char[cap];
-        for(u32 i = 0; i < len; i++) {
-            data[i] = str[i];
-        }
-        data[len] = '\0';
+const char* memchr_simple(const char* str, char c, u32 n) {
+    using namespace detail;
+    u32 i = 0;
+    for(; i + simd_width <= n; i += simd_width) {
+        simd_mask m = mask_byte(str + i, c);
+        if(m) return str + i + first_lane(m);
+    }
+    for(; i < n; i++) {
+        if(str[i] == c) return str + i;
     }
+    return nullptr;
+}
+
+// Substring search: filters candidate positions by comparing the first and
+// last needle bytes a block at a time, then verifies each candidate.
+const char* memmem_simple(const char* hay, u32 hay_len, const char* needle, u32 needle_len) {
+    using namespace detail;
+    if(needle_len == 0) return hay;
+    if(needle_len > hay_len) return nullptr;
+    if(needle_len == 1) return memchr_simple(hay, needle[0], hay_len);
 
-    string(const string& other) : len(other.len), cap(other.cap) {
-        data = new char[cap];
-        for(u32 i = 0; i <= len; i++) {
-            data[i] = other.data[i];
+    char first = needle[0];
+    char last = needle[needle_len - 1];
+    u32 last_start = hay_len - needle_len;
+    u32 i = 0;
+    for(; i + simd_width <= last_start + 1; i += simd_width) {
+        simd_mask m = mask_byte(hay + i, first) & mask_byte(hay + i + needle_len - 1, last);
+        while(m) {
+            u32 lane = first_lane(m);
+            if(memeq_simple(hay + i + lane + 1, needle + 1, needle_len - 2)) return hay + i + lane;
+            m &= ~(simd_lane << (lane * simd_bits));
         }
     }
+    for(; i <= last_start; i++) {
+        if(hay[i] == first && hay[i + needle_len - 1] == last
+           && memeq_simple(hay + i + 1, needle + 1, needle_len - 2)) return hay + i;
+    }
+    return nullptr;
+}
+
+// Opt-in runtime counters. Build with -DRAZ_INSTRUMENT to record them; without it
+// every RAZ_STAT(...) expands to nothing and no state exists.
+#ifdef RAZ_INSTRUMENT
+#define RAZ_STAT(...) __VA_ARGS__
 
-    ~string() {
-        delete[] data;
+struct container_stats {
+    u64 allocations = 0;
+    u64 bytes = 0;
+    u64 growths = 0;
+    u64 copies = 0;
+    u64 peak_capacity = 0;
+    u64 lookups = 0;
+    u64 scanned = 0;
+    u64 max_scan = 0;
+
+    void record_alloc(u64 size, u64 capacity) {
+        allocations++;
+        bytes += size;
+        if(capacity > peak_capacity) peak_capacity = capacity;
+    }
+    void record_growth() { growths++; }
+    void record_copy() { copies++; }
+    void record_scan(u64 length) {
+        lookups++;
+        scanned += length;
+        if(length > max_scan) max_scan = length;
     }
+};
 
-    u32 length() const { return len; }
-    u32 capacity() const { return cap; }
-    bool empty() const { return len == 0; }
+struct stream_stats {
+    u64 syscalls = 0;
+    u64 bytes = 0;
 
-    void push_back(char c) {
-        if(len + 1 >= cap) resize(cap * 2);
-        data[len++] = c;
-        data[len] = '\0';
+    void record_io(long n) {
+        syscalls++;
+        if(n > 0) bytes += (u64)n;
     }
+};
 
-    void append(const char* str) {
-        u32 str_len = strlen_simple(str);
-        if(len + str_len >= cap) resize((len + str_len) * 2);
-        for(u32 i = 0; i < str_len; i++) {
-            data[len++] = str[i];
-        }
-        data[len] = '\0';
+struct instrument_stats {
+    container_stats strings;
+    container_stats vectors;
+    container_stats maps;
+    container_stats hash_maps;
+    container_stats deques;
+    stream_stats ostreams;
+    stream_stats istreams;
+};
+
+static instrument_stats stats;
+#else
+#define RAZ_STAT(...)
+#endif
+
+#ifndef RAZ_ALLOC_ALIGN
+#define RAZ_ALLOC_ALIGN 16
+#endif
+
+u64 align_up(u64 value, u64 align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+namespace detail {
+
+// thread_pool workers are raw clone()s sharing their creator's TLS, and with
+// it libc's per-thread malloc cache, so raz keeps a heap of its own that needs
+// no TLS. While any such thread is alive its calls are serialized. Both are
+// defined with the threading code.
+static u32 shared_tls_threads = 0;
+__attribute__((malloc)) inline void* heap_alloc(u64 size);
+inline void heap_free(void* ptr);
+
+}
+
+struct heap_allocator {
+    void* allocate(u64 size) { return detail::heap_alloc(size); }
+    void deallocate(void* ptr, u64) { detail::heap_free(ptr); }
+};
+
+// Allocator handle over a memory resource (arena, pool, fixed_buffer). The
+// resource must outlive every container that uses it.
+template<typename R>
+struct resource_allocator {
+    R* resource;
+
+    resource_allocator(R& r) : resource(&r) {}
+
+    // Containers do not check for nullptr, so an exhausted resource traps here
+    // rather than crashing later on a write through a null pointer.
+    void* allocate(u64 size) {
+        void* ptr = resource->allocate(size);
+        if(!ptr) __builtin_trap();
+        return ptr;
     }
 
-    char& operator[](u32 index) { return data[index]; }
-    const char& operator[](u32 index) const { return data[index]; }
+    void deallocate(void* ptr, u64 size) { resource->deallocate(ptr, size); }
+};
 
-    string& operator=(const string& other) {
-        if(this != &other) {
-            delete[] data;
-            len = other.len;
-            cap = other.cap;
-            data = new char[cap];
-            for(u32 i = 0; i <= len; i++) {
-                data[i] = other.data[i];
-            }
-        }
-        return *this;
+class arena {
+private:
+    struct block {
+        block* next;
+        u64 size;
+        u64 used;
+    };
+
+    block* head;
+    u64 block_size;
+
+    static char* block_data(block* b) {
+        return (char*)b + align_up(sizeof(block), RAZ_ALLOC_ALIGN);
     }
 
-    string& operator+=(const char* str) { append(str); return *this; }
-    string& operator+=(char c) { push_back(c); return *this; }
+public:
+    arena(u64 default_block_size = 64 * 1024) : head(nullptr), block_size(default_block_size) {}
 
-    const char* c_str() const { return data; }
-    void clear() { len = 0; data[0] = '\0'; }
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
 
-    bool starts_with(const char* prefix) const {
-        u32 prefix_len = strlen_simple(prefix);
-        if(prefix_len > len) return false;
-        for(u32 i = 0; i < prefix_len; i++) {
-            if(data[i] != prefix[i]) return false;
-        }
-        return true;
+    ~arena() {
+        release();
     }
 
-    bool ends_with(const char* suffix) const {
-        u32 suffix_len = strlen_simple(suffix);
-        if(suffix_len > len) return false;
-        for(u32 i = 0; i < suffix_len; i++) {
-            if(data[len - suffix_len + i] != suffix[i]) return false;
+    void* allocate(u64 size) {
+        size = align_up(size ? size : 1, RAZ_ALLOC_ALIGN);
+        if(!head || head->used + size > head->size) {
+            u64 bytes = size > block_size ? size : block_size;
+            block* b = (block*)detail::heap_alloc(align_up(sizeof(block), RAZ_ALLOC_ALIGN) + bytes);
+            b->next = head;
+            b->size = bytes;
+            b->used = 0;
+            head = b;
         }
-        return true;
+        void* ptr = block_data(head) + head->used;
+        head->used += size;
+        return ptr;
     }
 
-    string substr(u32 start, u32 count = -1) const {
-        if(start >= len) return string("");
-        u32 actual_count = (count == (u32)-1) ? len - start : count;
-        if(start + actual_count > len) actual_count = len - start;
-        
-        string result;
-        for(u32 i = 0; i < actual_count; i++) {
-            result.push_back(data[start + i]);
-        }
-        return result;
+    // Only the most recent allocation is given back; everything else is
+    // reclaimed by reset().
+    void deallocate(void* ptr, u64 size) {
+        if(!head || !ptr) return;
+        size = align_up(size ? size : 1, RAZ_ALLOC_ALIGN);
+        if((char*)ptr + size == block_data(head) + head->used) head->used -= size;
     }
 
-    bool operator==(const string& other) const {
-        if(len != other.len) return false;
-        for(u32 i = 0; i < len; i++) {
-            if(data[i] != other.data[i]) return false;
+    void reset() {
+        if(!head) return;
+        while(head->next) {
+            block* next = head->next;
+            head->next = next->next;
+            detail::heap_free(next);
         }
-        return true;
+        head->used = 0;
     }
 
-    bool operator==(const char* other) const {
-        u32 other_len = strlen_simple(other);
-        if(len != other_len) return false;
-        for(u32 i = 0; i < len; i++) {
-            if(data[i] != other[i]) return false;
+    void release() {
+        while(head) {
+            block* next = head->next;
+            detail::heap_free(head);
+            head = next;
         }
-        return true;
     }
 
-    bool operator!=(const string& other) const {
-        return !(*this == other);
+    u64 bytes_used() const {
+        u64 total = 0;
+        for(block* b = head; b; b = b->next) total += b->used;
+        return total;
     }
+};
 
-    bool operator!=(const char* other) const {
-        return !(*this == other);
+class fixed_buffer {
+private:
+    char* memory;
+    u64 size;
+    u64 used;
+
+public:
+    fixed_buffer(void* buffer, u64 bytes) : used(0) {
+        char* begin = (char*)align_up((u64)buffer, RAZ_ALLOC_ALIGN);
+        u64 skipped = (u64)(begin - (char*)buffer);
+        memory = begin;
+        size = bytes > skipped ? bytes - skipped : 0;
     }
 
-    i32 compare(const char* other) const {
-        return strcmp_simple(data, other);
+    fixed_buffer(const fixed_buffer&) = delete;
+    fixed_buffer& operator=(const fixed_buffer&) = delete;
+
+    void* allocate(u64 bytes) {
+        bytes = align_up(bytes ? bytes : 1, RAZ_ALLOC_ALIGN);
+        if(used + bytes > size) return nullptr;
+        void* ptr = memory + used;
+        used += bytes;
+        return ptr;
     }
 
-    i32 compare(const string& other) const {
-        return strcmp_simple(data, other.data);
+    void deallocate(void* ptr, u64 bytes) {
+        if(!ptr) return;
+        bytes = align_up(bytes ? bytes : 1, RAZ_ALLOC_ALIGN);
+        if((char*)ptr + bytes == memory + used) used -= bytes;
     }
+
+    void reset() { used = 0; }
+    u64 bytes_used() const { return used; }
+    u64 bytes_free() const { return size - used; }
 };
 
-class ostream {
+class pool {
 private:
-    void write_char(char c) {
-        #if defined(__linux__)
-        asm volatile (
-            "mov $4, %%eax\n"
-            "mov $1, %%ebx\n"
-            "mov %0, %%ecx\n"
-            "mov $1, %%edx\n"
-            "int $0x80"
-            :
-            : "r"(&c)
-            : "eax", "ebx", "ecx", "edx"
-        );
-        #endif
-    }
+    struct node {
+        node* next;
+    };
 
-    void write_string(const char* str) {
-        u32 len = strlen_simple(str);
-        #if defined(__linux__)
-        asm volatile (
-            "mov $4, %%eax\n"
-            "mov $1, %%ebx\n"
-            "mov %0, %%ecx\n"
-            "mov %1, %%edx\n"
-            "int $0x80"
-            :
-            : "r"(str), "r"(len)
-            : "eax", "ebx", "ecx", "edx"
-        );
-        #else
-        for(u32 i = 0; i < len; i++) write_char(str[i]);
-        #endif
+    char* memory;
+    node* free_list;
+    u64 block;
+    u32 count;
+    u32 available;
+    bool owns_memory;
+
+    void build_free_list() {
+        free_list = nullptr;
+        for(u32 i = count; i > 0; i--) {
+            node* n = (node*)(memory + (u64)(i - 1) * block);
+            n->next = free_list;
+            free_list = n;
+        }
+        available = count;
     }
 
 public:
-    ostream& operator<<(const char* str) { write_string(str); return *this; }
-    ostream& operator<<(const string& str) { write_string(str.c_str()); return *this; }
-    ostream& operator<<(char c) { write_char(c); return *this; }
-    ostream& operator<<(const endl_t&) { write_char('\n'); return *this; }
-    ostream& operator<<(bool b) { write_string(b ? "true" : "false"); return *this; }
+    pool(u64 block_size, u32 block_count) : owns_memory(true) {
+        block = align_up(block_size < sizeof(node) ? sizeof(node) : block_size, RAZ_ALLOC_ALIGN);
+        count = block_count;
+        memory = (char*)detail::heap_alloc(block * count);
+        build_free_list();
+    }
 
-    ostream& operator<<(i32 num) {
-        char buffer[32];
-        i32 i = 0;
-        bool negative = num < 0;
-        if(negative) num = -num;
-
-        do {
-            buffer[i++] = '0' + (num % 10);
-            num /= 10;
-        } while(num > 0);
-        
-        if(negative) buffer[i++] = '-';
-
-        for(i32 j = 0; j < i / 2; j++) {
-            char temp = buffer[j];
-            buffer[j] = buffer[i - j - 1];
-            buffer[i - j - 1] = temp;
-        }
-        buffer[i] = '\0';
-        write_string(buffer);
-        return *this;
+    pool(void* buffer, u64 bytes, u64 block_size) : owns_memory(false) {
+        block = align_up(block_size < sizeof(node) ? sizeof(node) : block_size, RAZ_ALLOC_ALIGN);
+        memory = (char*)align_up((u64)buffer, RAZ_ALLOC_ALIGN);
+        u64 skipped = (u64)(memory - (char*)buffer);
+        count = bytes > skipped ? (u32)((bytes - skipped) / block) : 0;
+        build_free_list();
     }
 
-    ostream& operator<<(u32 num) {
-        char buffer[32];
-        u32 i = 0;
+    pool(const pool&) = delete;
+    pool& operator=(const pool&) = delete;
 
-        do {
-            buffer[i++] = '0' + (num % 10);
-            num /= 10;
-        } while(num > 0);
+    ~pool() {
+        if(owns_memory) detail::heap_free(memory);
+    }
 
-        for(u32 j = 0; j < i / 2; j++) {
-            char temp = buffer[j];
-            buffer[j] = buffer[i - j - 1];
-            buffer[i - j - 1] = temp;
-        }
-        buffer[i] = '\0';
-        write_string(buffer);
-        return *this;
+    void* allocate(u64 size) {
+        if(size > block || !free_list) return nullptr;
+        node* n = free_list;
+        free_list = n->next;
+        available--;
+        return n;
     }
 
-    ostream& operator<<(f64 num) {
-        i32 int_part = (i32)num;
-        *this << int_part << ".";
-        
-        f64 decimal = num - int_part;
-        if(decimal < 0) decimal = -decimal;
-        
-        for(i32 i = 0; i < 4; i++) {
-            decimal *= 10;
-            i32 digit = (i32)decimal;
-            *this << digit;
-            decimal -= digit;
-        }
-        return *this;
+    void deallocate(void* ptr, u64) {
+        if(!ptr) return;
+        node* n = (node*)ptr;
+        n->next = free_list;
+        free_list = n;
+        available++;
     }
-};
 
-static ostream cout;
+    void reset() { build_free_list(); }
+    u64 block_size() const { return block; }
+    u32 blocks_free() const { return available; }
+};
 
-void print(const char* str) { cout << str; }
-void print(const string& str) { cout << str; }
-void print(i32 num) { cout << num; }
-void print(u32 num) { cout << num; }
-void print(f64 num) { cout << num; }
-void print(bool b) { cout << b; }
+using arena_allocator = resource_allocator<arena>;
+using pool_allocator = resource_allocator<pool>;
+using buffer_allocator = resource_allocator<fixed_buffer>;
 
-void println(const char* str) { cout << str << endl; }
-void println(const string& str) { cout << str << endl; }
-void println(i32 num) { cout << num << endl; }
-void println(u32 num) { cout << num << endl; }
-void println(f64 num) { cout << num << endl; }
-void println(bool b) { cout << b << endl; }
+class split_range;
 
-class istream {
+// Non-owning view of `len` bytes; not necessarily NUL-terminated.
+class string_view {
 private:
-    char read_char() {
-        char c;
-        #if defined(__linux__)
-        asm volatile (
-            "mov $3, %%eax\n"
-            "mov $0, %%ebx\n"
-            "mov %0, %%ecx\n"
-            "mov $1, %%edx\n"
-            "int $0x80"
-            :
-            : "r"(&c)
-            : "eax", "ebx", "ecx", "edx"
-        );
-        #endif
-        return c;
+    const char* ptr;
+    u32 len;
+
+    static constexpr u32 constant_strlen(const char* str) {
+        u32 n = 0;
+        while(str[n]) n++;
+        return n;
     }
 
 public:
-    istream& operator>>(string& str) {
-        str.clear();
-        char c;
-        while(true) {
-            c = read_char();
-            if(c == '\n' || c == ' ') break;
-            str.push_back(c);
-        }
-        return *this;
+    constexpr string_view() : ptr(""), len(0) {}
+    constexpr string_view(const char* str)
+        : ptr(str), len(__builtin_is_constant_evaluated() ? constant_strlen(str) : strlen_simple(str)) {}
+    constexpr string_view(const char* str, u32 str_len) : ptr(str), len(str_len) {}
+
+    constexpr const char* data() const { return ptr; }
+    constexpr u32 length() const { return len; }
+    constexpr u32 size() const { return len; }
+    constexpr bool empty() const { return len == 0; }
+
+    constexpr char operator[](u32 index) const { return ptr[index]; }
+    constexpr char front() const { return ptr[0]; }
+    constexpr char back() const { return ptr[len - 1]; }
+    constexpr const char* begin() const { return ptr; }
+    constexpr const char* end() const { return ptr + len; }
+
+    void remove_prefix(u32 n) { n = n < len ? n : len; ptr += n; len -= n; }
+    void remove_suffix(u32 n) { len -= n < len ? n : len; }
+
+    string_view substr(u32 start, u32 count = -1) const {
+        if(start >= len) return string_view(ptr + len, 0);
+        u32 rest = len - start;
+        return string_view(ptr + start, count < rest ? count : rest);
     }
 
-    istream& operator>>(i32& num) {
-        string str;
-        *this >> str;
-        num = 0;
-        bool negative = false;
-        u32 i = 0;
-        
-        if(str[0] == '-') {
-            negative = true;
-            i = 1;
-        }
-        
-        for(; i < str.length(); i++) {
-            num = num * 10 + (str[i] - '0');
-        }
-        
-        if(negative) num = -num;
-        return *this;
+    bool starts_with(string_view prefix) const {
+        return prefix.len <= len && memeq_simple(ptr, prefix.ptr, prefix.len);
     }
 
-    istream& operator>>(u32& num) {
-        string str;
-        *this >> str;
-        num = 0;
-        for(u32 i = 0; i < str.length(); i++) {
-            num = num * 10 + (str[i] - '0');
-        }
-        return *this;
+    bool starts_with(char c) const { return len > 0 && ptr[0] == c; }
+
+    bool ends_with(string_view suffix) const {
+        return suffix.len <= len && memeq_simple(ptr + len - suffix.len, suffix.ptr, suffix.len);
     }
 
-    istream& operator>>(f64& num) {
-        string str;
-        *this >> str;
-        num = 0.0;
-        bool negative = false;
-        u32 i = 0;
-        
-        if(str[0] == '-') {
-            negative = true;
-            i = 1;
-        }
-        
-        // Parte entera
-        for(; i < str.length() && str[i] != '.'; i++) {
-            num = num * 10.0 + (str[i] - '0');
-        }
-        
-        // Parte decimal
-        if(i < str.length() && str[i] == '.') {
-            f64 decimal = 0.0;
-            f64 factor = 0.1;
-            i++;
-            for(; i < str.length(); i++) {
-                decimal += (str[i] - '0') * factor;
-                factor *= 0.1;
-            }
-            num += decimal;
-        }
-        
-        if(negative) num = -num;
-        return *this;
+    bool ends_with(char c) const { return len > 0 && ptr[len - 1] == c; }
+
+    i32 find(string_view needle, u32 from = 0) const {
+        if(from > len) return -1;
+        const char* found = memmem_simple(ptr + from, len - from, needle.ptr, needle.len);
+        return found ? (i32)(found - ptr) : -1;
     }
 
-    istream& operator>>(char& c) {
-        c = read_char();
-        return *this;
+    i32 find(char c, u32 from = 0) const {
+        if(from >= len) return -1;
+        const char* found = memchr_simple(ptr + from, c, len - from);
+        return found ? (i32)(found - ptr) : -1;
     }
 
-    istream& getline(string& str) {
-        str.clear();
-        char c;
-        while(true) {
-            c = read_char();
-            if(c == '\n') break;
-            str.push_back(c);
+    i32 rfind(char c) const {
+        for(u32 i = len; i > 0; i--) {
+            if(ptr[i - 1] == c) return (i32)(i - 1);
         }
-        return *this;
+        return -1;
     }
-};
 
-static istream cin;
+    bool contains(string_view needle) const { return find(needle) >= 0; }
+    bool contains(char c) const { return find(c) >= 0; }
 
-string input(const char* prompt = "") {
-    if(strlen_simple(prompt) > 0) {
-        raz::cout << prompt;
+    // Strips spaces, tabs and line breaks.
+    string_view trim() const {
+        u32 first = 0, last = len;
+        while(first < last && (ptr[first] == ' ' || ptr[first] == '\t' || ptr[first] == '\n' || ptr[first] == '\r')) first++;
+        while(last > first && (ptr[last - 1] == ' ' || ptr[last - 1] == '\t' || ptr[last - 1] == '\n' || ptr[last - 1] == '\r')) last--;
+        return string_view(ptr + first, last - first);
     }
-    string result;
-    raz::cin.getline(result);
-    return result;
-}
 
-template<typename T>
-T input_as(const char* prompt = "") {
-    if(strlen_simple(prompt) > 0) {
-        raz::cout << prompt;
+    i32 compare(string_view other) const {
+        u32 n = len < other.len ? len : other.len;
+        i32 c = memcmp_simple(ptr, other.ptr, n);
+        if(c != 0) return c;
+        return len < other.len ? -1 : len > other.len ? 1 : 0;
     }
-    T result;
-    raz::cin >> result;
+
+    // Whole-view parse; see raz::parse.
+    template<typename T>
+    parse_result<T> parse() const;
+
+    // Lazy pieces between `delim` ("a,,b" yields "a", "", "b").
+    split_range split(char delim) const;
+
+    // Lazy lines without their '\n' or "\r\n"; no empty piece after a final newline.
+    split_range lines() const;
+
+    friend bool operator==(string_view a, string_view b) { return a.len == b.len && memeq_simple(a.ptr, b.ptr, a.len); }
+    friend bool operator!=(string_view a, string_view b) { return !(a == b); }
+    friend bool operator<(string_view a, string_view b) { return a.compare(b) < 0; }
+    friend bool operator>(string_view a, string_view b) { return a.compare(b) > 0; }
+    friend bool operator<=(string_view a, string_view b) { return a.compare(b) <= 0; }
+    friend bool operator>=(string_view a, string_view b) { return a.compare(b) >= 0; }
+};
+
+class split_iterator {
+private:
+    const char* cur;
+    const char* piece_end;
+    const char* stop;
+    char delim;
+    bool line_mode;
+
+    // Scans in windows so texts over 4GB (mapped files) work with the u32 kernel.
+    void scan() {
+        const char* p = cur;
+        while(true) {
+            u64 left = (u64)(stop - p);
+            u32 n = left > (1u << 30) ? (1u << 30) : (u32)left;
+            const char* hit = memchr_simple(p, delim, n);
+            if(hit || n == left) {
+                piece_end = hit ? hit : stop;
+                return;
+            }
+            p += n;
+        }
+    }
+
+public:
+    split_iterator() : cur(nullptr), piece_end(nullptr), stop(nullptr), delim(0), line_mode(false) {}
+
+    split_iterator(string_view text, char d, bool lines) : split_iterator(text.begin(), text.end(), d, lines) {}
+
+    split_iterator(const char* first, const char* last, char d, bool lines)
+        : cur(first), piece_end(nullptr), stop(last), delim(d), line_mode(lines) {
+        if(line_mode && cur == stop) {
+            cur = nullptr;
+            return;
+        }
+        scan();
+    }
+
+    string_view operator*() const {
+        u32 n = (u32)(piece_end - cur);
+        if(line_mode && n > 0 && cur[n - 1] == '\r') n--;
+        return string_view(cur, n);
+    }
+
+    split_iterator& operator++() {
+        if(piece_end == stop) {
+            cur = nullptr;
+            return *this;
+        }
+        cur = piece_end + 1;
+        if(line_mode && cur == stop) {
+            cur = nullptr;
+            return *this;
+        }
+        scan();
+        return *this;
+    }
+
+    bool operator==(const split_iterator& other) const { return cur == other.cur; }
+    bool operator!=(const split_iterator& other) const { return cur != other.cur; }
+};
+
+class split_range {
+private:
+    split_iterator first;
+
+public:
+    split_range(string_view text, char delim, bool lines) : first(text, delim, lines) {}
+    split_range(const char* begin, const char* end, char delim, bool lines) : first(begin, end, delim, lines) {}
+
+    split_iterator begin() const { return first; }
+    split_iterator end() const { return split_iterator(); }
+
+    // Pull-style alternative to the range-for loop.
+    bool next(string_view& piece) {
+        if(first == split_iterator()) return false;
+        piece = *first;
+        ++first;
+        return true;
+    }
+};
+
+split_range string_view::split(char delim) const { return split_range(*this, delim, false); }
+split_range string_view::lines() const { return split_range(*this, '\n', true); }
+
+#ifndef RAZ_STRING_SSO_SIZE
+#define RAZ_STRING_SSO_SIZE 24
+#endif
+
+template<typename A>
+class basic_string {
+private:
+    char* data;
+    u32 len;
+    u32 cap;
+    [[no_unique_address]] A alloc;
+    char local[RAZ_STRING_SSO_SIZE];
+
+    bool is_local() const { return data == local; }
+
+    void init(const char* str, u32 str_len) {
+        len = str_len;
+        if(len < RAZ_STRING_SSO_SIZE) {
+            data = local;
+            cap = RAZ_STRING_SSO_SIZE;
+        } else {
+            cap = len + 1;
+            data = (char*)alloc.allocate(cap);
+            RAZ_STAT(stats.strings.record_alloc(cap, cap));
+        }
+        memcpy_simple(data, str, len);
+        data[len] = '\0';
+    }
+
+    void release() {
+        if(!is_local()) alloc.deallocate(data, cap);
+    }
+
+    void reset_local() {
+        data = local;
+        len = 0;
+        cap = RAZ_STRING_SSO_SIZE;
+        local[0] = '\0';
+    }
+
+    void reallocate(u32 new_cap) {
+        char* new_data = (char*)alloc.allocate(new_cap);
+        RAZ_STAT(stats.strings.record_alloc(new_cap, new_cap));
+        RAZ_STAT(stats.strings.record_growth());
+        memcpy_simple(new_data, data, len + 1);
+        release();
+        data = new_data;
+        cap = new_cap;
+    }
+
+    void grow_for(u32 extra) {
+        u32 needed = len + extra + 1;
+        if(needed <= cap) return;
+        u32 new_cap = cap * 2;
+        if(new_cap < needed) new_cap = needed;
+        reallocate(new_cap);
+    }
+
+public:
+    basic_string(const A& a = A()) : alloc(a) { reset_local(); }
+
+    basic_string(const char* str, const A& a = A()) : alloc(a) { init(str, strlen_simple(str)); }
+
+    basic_string(const char* str, u32 str_len, const A& a = A()) : alloc(a) { init(str, str_len); }
+
+    explicit basic_string(string_view str, const A& a = A()) : alloc(a) { init(str.data(), str.length()); }
+
+    basic_string(const basic_string& other) : alloc(other.alloc) {
+        RAZ_STAT(stats.strings.record_copy());
+        init(other.data, other.len);
+    }
+
+    basic_string(basic_string&& other) : alloc(other.alloc) {
+        if(other.is_local()) {
+            init(other.data, other.len);
+        } else {
+            data = other.data;
+            len = other.len;
+            cap = other.cap;
+        }
+        other.reset_local();
+    }
+
+    ~basic_string() {
+        release();
+    }
+
+    u32 length() const { return len; }
+    u32 capacity() const { return cap; }
+    bool empty() const { return len == 0; }
+
+    void reserve(u32 new_len) {
+        if(new_len + 1 > cap) reallocate(new_len + 1);
+    }
+
+    void resize(u32 new_len, char fill = '\0') {
+        if(new_len > len) {
+            grow_for(new_len - len);
+            for(u32 i = len; i < new_len; i++) data[i] = fill;
+        }
+        len = new_len;
+        data[len] = '\0';
+    }
+
+    void push_back(char c) {
+        grow_for(1);
+        data[len++] = c;
+        data[len] = '\0';
+    }
+
+    void append(const char* str, u32 str_len) {
+        grow_for(str_len);
+        memcpy_simple(data + len, str, str_len);
+        len += str_len;
+        data[len] = '\0';
+    }
+
+    void append(const char* str) {
+        append(str, strlen_simple(str));
+    }
+
+    void append(const basic_string& other) {
+        append(other.data, other.len);
+    }
+
+    void append(string_view str) {
+        append(str.data(), str.length());
+    }
+
+    char& operator[](u32 index) { return data[index]; }
+    const char& operator[](u32 index) const { return data[index]; }
+
+    basic_string& operator=(const basic_string& other) {
+        if(this != &other) {
+            RAZ_STAT(stats.strings.record_copy());
+            len = 0;
+            grow_for(other.len);
+            memcpy_simple(data, other.data, other.len + 1);
+            len = other.len;
+        }
+        return *this;
+    }
+
+    basic_string& operator=(basic_string&& other) {
+        if(this == &other) return *this;
+        if(other.is_local()) {
+            memcpy_simple(data, other.data, other.len + 1);
+            len = other.len;
+        } else {
+            release();
+            alloc = other.alloc;
+            data = other.data;
+            len = other.len;
+            cap = other.cap;
+        }
+        other.reset_local();
+        return *this;
+    }
+
+    basic_string& operator+=(const char* str) { append(str); return *this; }
+    basic_string& operator+=(const basic_string& other) { append(other); return *this; }
+    basic_string& operator+=(string_view str) { append(str); return *this; }
+    basic_string& operator+=(char c) { push_back(c); return *this; }
+
+    const char* c_str() const { return data; }
+    const A& get_allocator() const { return alloc; }
+    void clear() { len = 0; data[0] = '\0'; }
+
+    string_view view() const { return string_view(data, len); }
+    operator string_view() const { return string_view(data, len); }
+
+    bool starts_with(string_view prefix) const { return view().starts_with(prefix); }
+    bool ends_with(string_view suffix) const { return view().ends_with(suffix); }
+
+    i32 find(string_view needle, u32 from = 0) const { return view().find(needle, from); }
+    i32 find(char c, u32 from = 0) const { return view().find(c, from); }
+
+    bool contains(string_view needle) const { return find(needle) >= 0; }
+    bool contains(char c) const { return find(c) >= 0; }
+
+    basic_string substr(u32 start, u32 count = -1) const {
+        if(start >= len) return basic_string(alloc);
+        u32 actual_count = (count == (u32)-1) ? len - start : count;
+        if(actual_count > len - start) actual_count = len - start;
+        return basic_string(data + start, actual_count, alloc);
+    }
+
+    bool operator==(const basic_string& other) const {
+        return len == other.len && memeq_simple(data, other.data, len);
+    }
+
+    bool operator==(const char* other) const {
+        return strcmp_simple(data, other) == 0;
+    }
+
+    bool operator!=(const basic_string& other) const {
+        return !(*this == other);
+    }
+
+    bool operator!=(const char* other) const {
+        return !(*this == other);
+    }
+
+    i32 compare(const char* other) const {
+        return strcmp_simple(data, other);
+    }
+
+    i32 compare(const basic_string& other) const {
+        return memcmp_simple(data, other.data, (len < other.len ? len : other.len) + 1);
+    }
+
+    bool operator<(const basic_string& other) const { return compare(other) < 0; }
+    bool operator>(const basic_string& other) const { return compare(other) > 0; }
+};
+
+using string = basic_string<heap_allocator>;
+
+namespace sys {
+
+#if defined(__x86_64__)
+static constexpr long nr_read = 0;
+static constexpr long nr_write = 1;
+static constexpr long nr_getrandom = 318;
+static constexpr long nr_openat = 257;
+static constexpr long nr_close = 3;
+static constexpr long nr_clock_gettime = 228;
+static constexpr long nr_mmap = 9;
+static constexpr long nr_munmap = 11;
+static constexpr long nr_mprotect = 10;
+static constexpr long nr_futex = 202;
+static constexpr long nr_clone = 56;
+static constexpr long nr_exit = 60;
+static constexpr long nr_sched_yield = 24;
+static constexpr long nr_sched_getaffinity = 204;
+static constexpr long nr_lseek = 8;
+static constexpr long nr_madvise = 28;
+static constexpr long nr_writev = 20;
+static constexpr long nr_fcntl = 72;
+#elif defined(__aarch64__)
+static constexpr long nr_read = 63;
+static constexpr long nr_write = 64;
+static constexpr long nr_getrandom = 278;
+static constexpr long nr_openat = 56;
+static constexpr long nr_close = 57;
+static constexpr long nr_clock_gettime = 113;
+static constexpr long nr_mmap = 222;
+static constexpr long nr_munmap = 215;
+static constexpr long nr_mprotect = 226;
+static constexpr long nr_futex = 98;
+static constexpr long nr_clone = 220;
+static constexpr long nr_exit = 93;
+static constexpr long nr_sched_yield = 124;
+static constexpr long nr_sched_getaffinity = 123;
+static constexpr long nr_lseek = 62;
+static constexpr long nr_madvise = 233;
+static constexpr long nr_writev = 66;
+static constexpr long nr_fcntl = 25;
+#elif defined(__i386__)
+static constexpr long nr_read = 3;
+static constexpr long nr_write = 4;
+static constexpr long nr_getrandom = 355;
+static constexpr long nr_openat = 295;
+static constexpr long nr_close = 6;
+static constexpr long nr_clock_gettime = 265;
+static constexpr long nr_mmap = 192;
+static constexpr long nr_munmap = 91;
+static constexpr long nr_mprotect = 125;
+static constexpr long nr_futex = 240;
+static constexpr long nr_clone = 120;
+static constexpr long nr_exit = 1;
+static constexpr long nr_sched_yield = 158;
+static constexpr long nr_sched_getaffinity = 242;
+static constexpr long nr_lseek = 19;
+static constexpr long nr_madvise = 219;
+static constexpr long nr_writev = 146;
+static constexpr long nr_fcntl = 55;
+#endif
+
+static constexpr long nr_io_uring_setup = 425;
+static constexpr long nr_io_uring_enter = 426;
+
+#if defined(__linux__) && defined(__x86_64__)
+#define RAZ_HAS_SYSCALL 1
+
+inline long syscall0(long n) {
+    long ret;
+    asm volatile ("syscall" : "=a"(ret) : "a"(n) : "rcx", "r11", "memory");
+    return ret;
+}
+
+inline long syscall1(long n, long a1) {
+    long ret;
+    asm volatile ("syscall" : "=a"(ret) : "a"(n), "D"(a1) : "rcx", "r11", "memory");
+    return ret;
+}
+
+inline long syscall2(long n, long a1, long a2) {
+    long ret;
+    asm volatile ("syscall" : "=a"(ret) : "a"(n), "D"(a1), "S"(a2) : "rcx", "r11", "memory");
+    return ret;
+}
+
+inline long syscall3(long n, long a1, long a2, long a3) {
+    long ret;
+    asm volatile ("syscall" : "=a"(ret) : "a"(n), "D"(a1), "S"(a2), "d"(a3) : "rcx", "r11", "memory");
+    return ret;
+}
+
+inline long syscall4(long n, long a1, long a2, long a3, long a4) {
+    long ret;
+    register long r10 asm("r10") = a4;
+    asm volatile ("syscall" : "=a"(ret) : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10) : "rcx", "r11", "memory");
+    return ret;
+}
+
+inline long syscall5(long n, long a1, long a2, long a3, long a4, long a5) {
+    long ret;
+    register long r10 asm("r10") = a4;
+    register long r8 asm("r8") = a5;
+    asm volatile ("syscall" : "=a"(ret) : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8) : "rcx", "r11", "memory");
+    return ret;
+}
+
+inline long syscall6(long n, long a1, long a2, long a3, long a4, long a5, long a6) {
+    long ret;
+    register long r10 asm("r10") = a4;
+    register long r8 asm("r8") = a5;
+    register long r9 asm("r9") = a6;
+    asm volatile ("syscall" : "=a"(ret) : "a"(n), "D"(a1), "S"(a2), "d"(a3), "r"(r10), "r"(r8), "r"(r9) : "rcx", "r11", "memory");
+    return ret;
+}
+
+#elif defined(__linux__) && defined(__aarch64__)
+#define RAZ_HAS_SYSCALL 1
+
+inline long syscall6(long n, long a1, long a2, long a3, long a4, long a5, long a6) {
+    register long x8 asm("x8") = n;
+    register long x0 asm("x0") = a1;
+    register long x1 asm("x1") = a2;
+    register long x2 asm("x2") = a3;
+    register long x3 asm("x3") = a4;
+    register long x4 asm("x4") = a5;
+    register long x5 asm("x5") = a6;
+    asm volatile ("svc #0" : "+r"(x0) : "r"(x8), "r"(x1), "r"(x2), "r"(x3), "r"(x4), "r"(x5) : "memory");
+    return x0;
+}
+
+inline long syscall0(long n) { return syscall6(n, 0, 0, 0, 0, 0, 0); }
+inline long syscall1(long n, long a1) { return syscall6(n, a1, 0, 0, 0, 0, 0); }
+inline long syscall2(long n, long a1, long a2) { return syscall6(n, a1, a2, 0, 0, 0, 0); }
+inline long syscall3(long n, long a1, long a2, long a3) { return syscall6(n, a1, a2, a3, 0, 0, 0); }
+inline long syscall4(long n, long a1, long a2, long a3, long a4) { return syscall6(n, a1, a2, a3, a4, 0, 0); }
+inline long syscall5(long n, long a1, long a2, long a3, long a4, long a5) { return syscall6(n, a1, a2, a3, a4, a5, 0); }
+
+#elif defined(__linux__) && defined(__i386__)
+#define RAZ_HAS_SYSCALL 1
+
+inline long syscall5(long n, long a1, long a2, long a3, long a4, long a5) {
+    long ret;
+    asm volatile ("int $0x80" : "=a"(ret) : "a"(n), "b"(a1), "c"(a2), "d"(a3), "S"(a4), "D"(a5) : "memory");
+    return ret;
+}
+
+inline long syscall6(long n, long a1, long a2, long a3, long a4, long a5, long a6) {
+    long ret;
+    asm volatile (
+        "pushl %7\n"
+        "push %%ebp\n"
+        "mov 4(%%esp), %%ebp\n"
+        "int $0x80\n"
+        "pop %%ebp\n"
+        "add $4, %%esp"
+        : "=a"(ret)
+        : "a"(n), "b"(a1), "c"(a2), "d"(a3), "S"(a4), "D"(a5), "g"(a6)
+        : "memory"
+    );
+    return ret;
+}
+
+inline long syscall0(long n) { return syscall5(n, 0, 0, 0, 0, 0); }
+inline long syscall1(long n, long a1) { return syscall5(n, a1, 0, 0, 0, 0); }
+inline long syscall2(long n, long a1, long a2) { return syscall5(n, a1, a2, 0, 0, 0); }
+inline long syscall3(long n, long a1, long a2, long a3) { return syscall5(n, a1, a2, a3, 0, 0); }
+inline long syscall4(long n, long a1, long a2, long a3, long a4) { return syscall5(n, a1, a2, a3, a4, 0); }
+
+#else
+#define RAZ_HAS_SYSCALL 0
+#endif
+
+static constexpr long err_intr = -4;
+static constexpr long err_again = -11;
+static constexpr long err_nosys = -38;
+
+inline long read(i32 fd, void* dest, u64 len) {
+    #if RAZ_HAS_SYSCALL
+    long ret;
+    do {
+        ret = syscall3(nr_read, fd, (long)dest, (long)len);
+    } while(ret == err_intr);
+    return ret;
+    #else
+    (void)fd; (void)dest; (void)len;
+    return err_nosys;
+    #endif
+}
+
+inline long write(i32 fd, const void* src, u64 len) {
+    #if RAZ_HAS_SYSCALL
+    const char* p = (const char*)src;
+    u64 done = 0;
+    while(done < len) {
+        long ret = syscall3(nr_write, fd, (long)(p + done), (long)(len - done));
+        if(ret == err_intr) continue;
+        if(ret < 0) return done > 0 ? (long)done : ret;
+        done += (u64)ret;
+    }
+    return (long)done;
+    #else
+    (void)fd; (void)src; (void)len;
+    return err_nosys;
+    #endif
+}
+
+static constexpr i32 at_fdcwd = -100;
+static constexpr i32 o_rdonly = 0;
+static constexpr i32 o_wronly = 1;
+static constexpr i32 o_rdwr = 2;
+static constexpr i32 o_creat = 0100;
+static constexpr i32 o_trunc = 01000;
+static constexpr i32 o_cloexec = 02000000;
+
+// Returns the descriptor or a negative errno.
+inline i32 open(const char* path, i32 flags, i32 mode = 0644) {
+    #if RAZ_HAS_SYSCALL
+    long ret;
+    do {
+        ret = syscall4(nr_openat, at_fdcwd, (long)path, flags | o_cloexec, mode);
+    } while(ret == err_intr);
+    return (i32)ret;
+    #else
+    (void)path; (void)flags; (void)mode;
+    return (i32)err_nosys;
+    #endif
+}
+
+inline long close(i32 fd) {
+    #if RAZ_HAS_SYSCALL
+    return syscall1(nr_close, fd);
+    #else
+    (void)fd;
+    return err_nosys;
+    #endif
+}
+
+// CLOCK_MONOTONIC in nanoseconds, 0 when unavailable.
+inline u64 monotonic_ns() {
+    #if RAZ_HAS_SYSCALL
+    long ts[2] = {0, 0};
+    if(syscall2(nr_clock_gettime, 1, (long)ts) < 0) return 0;
+    return (u64)ts[0] * 1000000000ULL + (u64)ts[1];
+    #else
+    return 0;
+    #endif
+}
+
+inline long getrandom(void* dest, u64 len) {
+    #if RAZ_HAS_SYSCALL
+    long ret;
+    do {
+        ret = syscall3(nr_getrandom, (long)dest, (long)len, 0);
+    } while(ret == err_intr);
+    return ret;
+    #else
+    (void)dest; (void)len;
+    return err_nosys;
+    #endif
+}
+
+static constexpr i32 prot_none = 0;
+static constexpr i32 prot_read = 1;
+static constexpr i32 prot_write = 2;
+static constexpr i32 map_shared = 0x01;
+static constexpr i32 map_private = 0x02;
+static constexpr i32 map_anonymous = 0x20;
+static constexpr i32 map_populate = 0x8000;
+static constexpr i32 map_stack = 0x20000;
+
+// Returns the mapping, or nullptr on failure.
+inline void* mmap(void* addr, u64 len, i32 prot, i32 flags, i32 fd = -1, long offset = 0) {
+    #if RAZ_HAS_SYSCALL
+    long ret = syscall6(nr_mmap, (long)addr, (long)len, prot, flags, fd, offset);
+    if(ret < 0 && ret > -4096) return nullptr;
+    return (void*)ret;
+    #else
+    (void)addr; (void)len; (void)prot; (void)flags; (void)fd; (void)offset;
+    return nullptr;
+    #endif
+}
+
+inline long munmap(void* addr, u64 len) {
+    #if RAZ_HAS_SYSCALL
+    return syscall2(nr_munmap, (long)addr, (long)len);
+    #else
+    (void)addr; (void)len;
+    return err_nosys;
+    #endif
+}
+
+inline long mprotect(void* addr, u64 len, i32 prot) {
+    #if RAZ_HAS_SYSCALL
+    return syscall3(nr_mprotect, (long)addr, (long)len, prot);
+    #else
+    (void)addr; (void)len; (void)prot;
+    return err_nosys;
+    #endif
+}
+
+static constexpr i32 madv_random = 1;
+static constexpr i32 madv_sequential = 2;
+static constexpr i32 madv_willneed = 3;
+static constexpr i32 madv_hugepage = 14;
+
+inline long madvise(void* addr, u64 len, i32 advice) {
+    #if RAZ_HAS_SYSCALL
+    return syscall3(nr_madvise, (long)addr, (long)len, advice);
+    #else
+    (void)addr; (void)len; (void)advice;
+    return err_nosys;
+    #endif
+}
+
+static constexpr i32 seek_set = 0;
+static constexpr i32 seek_cur = 1;
+static constexpr i32 seek_end = 2;
+
+// New offset, or a negative errno.
+inline long lseek(i32 fd, long offset, i32 whence) {
+    #if RAZ_HAS_SYSCALL
+    return syscall3(nr_lseek, fd, offset, whence);
+    #else
+    (void)fd; (void)offset; (void)whence;
+    return err_nosys;
+    #endif
+}
+
+static constexpr i32 f_getfl = 3;
+static constexpr i32 o_append = 02000;
+
+inline long fcntl(i32 fd, i32 cmd, long arg = 0) {
+    #if RAZ_HAS_SYSCALL
+    return syscall3(nr_fcntl, fd, cmd, arg);
+    #else
+    (void)fd; (void)cmd; (void)arg;
+    return err_nosys;
+    #endif
+}
+
+struct iovec {
+    const void* base;
+    unsigned long len;
+};
+
+// One gathered write; may be partial. Returns bytes written or a negative errno.
+inline long writev(i32 fd, const iovec* iov, i32 count) {
+    #if RAZ_HAS_SYSCALL
+    long ret;
+    do {
+        ret = syscall3(nr_writev, fd, (long)iov, count);
+    } while(ret == err_intr);
+    return ret;
+    #else
+    (void)fd; (void)iov; (void)count;
+    return err_nosys;
+    #endif
+}
+
+// io_uring ABI (linux/io_uring.h), only what raz uses.
+struct io_sqring_offsets {
+    u32 head, tail, ring_mask, ring_entries, flags, dropped, array, resv1;
+    u64 user_addr;
+};
+
+struct io_cqring_offsets {
+    u32 head, tail, ring_mask, ring_entries, overflow, cqes, flags, resv1;
+    u64 user_addr;
+};
+
+struct io_uring_params {
+    u32 sq_entries, cq_entries, flags, sq_thread_cpu, sq_thread_idle, features, wq_fd, resv[3];
+    io_sqring_offsets sq_off;
+    io_cqring_offsets cq_off;
+};
+
+struct io_uring_sqe {
+    u8 opcode;
+    u8 flags;
+    u16 ioprio;
+    i32 fd;
+    u64 off;
+    u64 addr;
+    u32 len;
+    u32 rw_flags;
+    u64 user_data;
+    u16 buf_index;
+    u16 personality;
+    i32 splice_fd_in;
+    u64 addr3;
+    u64 pad;
+};
+
+struct io_uring_cqe {
+    u64 user_data;
+    i32 res;
+    u32 flags;
+};
+
+static constexpr u8 ioring_op_writev = 2;
+static constexpr u32 ioring_feat_single_mmap = 1;
+static constexpr u32 ioring_enter_getevents = 1;
+static constexpr long ioring_off_sq_ring = 0;
+static constexpr long ioring_off_cq_ring = 0x8000000;
+static constexpr long ioring_off_sqes = 0x10000000;
+
+inline i32 io_uring_setup(u32 entries, io_uring_params* params) {
+    #if RAZ_HAS_SYSCALL
+    return (i32)syscall2(nr_io_uring_setup, entries, (long)params);
+    #else
+    (void)entries; (void)params;
+    return (i32)err_nosys;
+    #endif
+}
+
+inline long io_uring_enter(i32 ring_fd, u32 to_submit, u32 min_complete, u32 flags) {
+    #if RAZ_HAS_SYSCALL
+    long ret;
+    do {
+        ret = syscall6(nr_io_uring_enter, ring_fd, to_submit, min_complete, flags, 0, 0);
+    } while(ret == err_intr);
+    return ret;
+    #else
+    (void)ring_fd; (void)to_submit; (void)min_complete; (void)flags;
+    return err_nosys;
+    #endif
+}
+
+static constexpr i32 futex_wait_op = 0;
+static constexpr i32 futex_wake_op = 1;
+static constexpr i32 futex_private = 128;
+
+// Sleeps while *addr == expected. Spurious returns are possible; callers
+// re-check their condition. Use shared = true for words the kernel itself
+// wakes (the CLONE_CHILD_CLEARTID tid).
+inline long futex_wait(u32* addr, u32 expected, bool shared = false) {
+    #if RAZ_HAS_SYSCALL
+    i32 op = futex_wait_op | (shared ? 0 : futex_private);
+    return syscall4(nr_futex, (long)addr, op, (long)expected, 0);
+    #else
+    (void)addr; (void)expected; (void)shared;
+    return err_nosys;
+    #endif
+}
+
+inline long futex_wake(u32* addr, i32 count, bool shared = false) {
+    #if RAZ_HAS_SYSCALL
+    i32 op = futex_wake_op | (shared ? 0 : futex_private);
+    return syscall3(nr_futex, (long)addr, op, count);
+    #else
+    (void)addr; (void)count; (void)shared;
+    return err_nosys;
+    #endif
+}
+
+inline void sched_yield() {
+    #if RAZ_HAS_SYSCALL
+    syscall0(nr_sched_yield);
+    #endif
+}
+
+// CPUs this process may run on, at least 1.
+inline u32 cpu_count() {
+    #if RAZ_HAS_SYSCALL
+    u64 mask[16] = {};
+    long ret = syscall3(nr_sched_getaffinity, 0, sizeof(mask), (long)mask);
+    if(ret <= 0) return 1;
+    u32 n = 0;
+    for(u32 i = 0; i < (u32)ret / 8; i++) n += (u32)__builtin_popcountll(mask[i]);
+    return n ? n : 1;
+    #else
+    return 1;
+    #endif
+}
+
+static constexpr long clone_thread_flags =
+    0x100 | 0x200 | 0x400 | 0x800 |  // CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND
+    0x10000 | 0x40000 |              // CLONE_THREAD | CLONE_SYSVSEM
+    0x100000 | 0x200000;             // CLONE_PARENT_SETTID | CLONE_CHILD_CLEARTID
+
+// Starts fn(arg) on a new kernel thread whose stack ends at stack_top (16-byte
+// aligned). The kernel stores the tid in *tid and clears it, with a futex wake,
+// when the thread exits. The child never returns here: it calls exit after fn.
+// Returns the tid or a negative errno.
+#if defined(__linux__) && defined(__x86_64__)
+#define RAZ_HAS_THREADS 1
+
+inline long clone_thread(void (*fn)(void*), void* arg, void* stack_top, u32* tid) {
+    long ret;
+    register long r10 asm("r10") = (long)tid;
+    register long r8 asm("r8") = 0;
+    register long r9 asm("r9") = (long)fn;
+    register long r12 asm("r12") = (long)arg;
+    asm volatile (
+        "syscall\n"
+        "test %%rax, %%rax\n"
+        "jnz 1f\n"
+        "xor %%ebp, %%ebp\n"
+        "mov %%r12, %%rdi\n"
+        "call *%%r9\n"
+        "mov %[nr_exit], %%eax\n"
+        "xor %%edi, %%edi\n"
+        "syscall\n"
+        "hlt\n"
+        "1:"
+        : "=a"(ret)
+        : "a"(nr_clone), "D"(clone_thread_flags), "S"(stack_top), "d"(tid), "r"(r10), "r"(r8), "r"(r9), "r"(r12),
+          [nr_exit] "i"(nr_exit)
+        : "rcx", "r11", "memory"
+    );
+    return ret;
+}
+
+#elif defined(__linux__) && defined(__aarch64__)
+#define RAZ_HAS_THREADS 1
+
+inline long clone_thread(void (*fn)(void*), void* arg, void* stack_top, u32* tid) {
+    register long x8 asm("x8") = nr_clone;
+    register long x0 asm("x0") = clone_thread_flags;
+    register long x1 asm("x1") = (long)stack_top;
+    register long x2 asm("x2") = (long)tid;
+    register long x3 asm("x3") = 0;
+    register long x4 asm("x4") = (long)tid;
+    register long x19 asm("x19") = (long)fn;
+    register long x20 asm("x20") = (long)arg;
+    asm volatile (
+        "svc #0\n"
+        "cbnz x0, 1f\n"
+        "mov x29, xzr\n"
+        "mov x30, xzr\n"
+        "mov x0, x20\n"
+        "blr x19\n"
+        "mov x8, %[nr_exit]\n"
+        "mov x0, xzr\n"
+        "svc #0\n"
+        "1:"
+        : "+r"(x0)
+        : "r"(x8), "r"(x1), "r"(x2), "r"(x3), "r"(x4), "r"(x19), "r"(x20), [nr_exit] "i"(nr_exit)
+        : "memory"
+    );
+    return x0;
+}
+
+#else
+#define RAZ_HAS_THREADS 0
+#endif
+
+}
+
+static constexpr u32 format_int_max = 24;
+static constexpr u32 format_float_max = 32;
+static constexpr u32 format_precision_max = 64;
+static constexpr u32 format_fixed_max = 1 + 309 + 1 + format_precision_max + 1;
+
+namespace detail {
+
+static constexpr char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+template<typename U>
+u32 count_digits(U value) {
+    u32 n = 1;
+    while(true) {
+        if(value < 10) return n;
+        if(value < 100) return n + 1;
+        if(value < 1000) return n + 2;
+        if(value < 10000) return n + 3;
+        value /= 10000;
+        n += 4;
+    }
+}
+
+template<typename U>
+u32 format_unsigned(char* out, U value) {
+    u32 n = count_digits(value);
+    char* p = out + n;
+    while(value >= 100) {
+        u32 idx = (u32)(value % 100) * 2;
+        value /= 100;
+        p -= 2;
+        p[0] = digit_pairs[idx];
+        p[1] = digit_pairs[idx + 1];
+    }
+    if(value >= 10) {
+        u32 idx = (u32)value * 2;
+        p[-2] = digit_pairs[idx];
+        p[-1] = digit_pairs[idx + 1];
+    } else {
+        p[-1] = (char)('0' + value);
+    }
+    return n;
+}
+
+// Grisu2 (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+// with Integers"). The output always round-trips and is the shortest
+// representation for all but a tiny fraction of inputs.
+struct diyfp {
+    u64 f;
+    i32 e;
+
+    constexpr diyfp(u64 f_, i32 e_) : f(f_), e(e_) {}
+
+    static diyfp sub(diyfp x, diyfp y) { return diyfp(x.f - y.f, x.e); }
+
+    static diyfp mul(diyfp x, diyfp y) {
+        u64 u_lo = x.f & 0xFFFFFFFFu, u_hi = x.f >> 32;
+        u64 v_lo = y.f & 0xFFFFFFFFu, v_hi = y.f >> 32;
+        u64 p0 = u_lo * v_lo, p1 = u_lo * v_hi, p2 = u_hi * v_lo, p3 = u_hi * v_hi;
+        u64 q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu) + (1ULL << 31);
+        return diyfp(p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64);
+    }
+
+    static diyfp normalize(diyfp x) {
+        while((x.f >> 63) == 0) {
+            x.f <<= 1;
+            x.e--;
+        }
+        return x;
+    }
+
+    static diyfp normalize_to(diyfp x, i32 target_exponent) {
+        return diyfp(x.f << (x.e - target_exponent), target_exponent);
+    }
+};
+
+struct cached_power {
+    u64 f;
+    i32 e;
+    i32 k;
+};
+
+// 10^k ~= f * 2^e for k = -300, -292, ..., 324.
+static constexpr cached_power cached_powers[] = {
+    { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+    { 0xBE5691EF416BD60CULL, -1007, -284 },
+    { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+    { 0xD3515C2831559A83ULL,  -954, -268 },
+    { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+    { 0xEA9C227723EE8BCBULL,  -901, -252 },
+    { 0xAECC49914078536DULL,  -874, -244 },
+    { 0x823C12795DB6CE57ULL,  -847, -236 },
+    { 0xC21094364DFB5637ULL,  -821, -228 },
+    { 0x9096EA6F3848984FULL,  -794, -220 },
+    { 0xD77485CB25823AC7ULL,  -768, -212 },
+    { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+    { 0xEF340A98172AACE5ULL,  -715, -196 },
+    { 0xB23867FB2A35B28EULL,  -688, -188 },
+    { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+    { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+    { 0x936B9FCEBB25C996ULL,  -608, -164 },
+    { 0xDBAC6C247D62A584ULL,  -582, -156 },
+    { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+    { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+    { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+    { 0x87625F056C7C4A8BULL,  -475, -124 },
+    { 0xC9BCFF6034C13053ULL,  -449, -116 },
+    { 0x964E858C91BA2655ULL,  -422, -108 },
+    { 0xDFF9772470297EBDULL,  -396, -100 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+    { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+    { 0xB94470938FA89BCFULL,  -316,  -76 },
+    { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+    { 0xCDB02555653131B6ULL,  -263,  -60 },
+    { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+    { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+    { 0xAA242499697392D3ULL,  -183,  -36 },
+    { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+    { 0xBCE5086492111AEBULL,  -130,  -20 },
+    { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+    { 0xD1B71758E219652CULL,   -77,   -4 },
+    { 0x9C40000000000000ULL,   -50,    4 },
+    { 0xE8D4A51000000000ULL,   -24,   12 },
+    { 0xAD78EBC5AC620000ULL,     3,   20 },
+    { 0x813F3978F8940984ULL,    30,   28 },
+    { 0xC097CE7BC90715B3ULL,    56,   36 },
+    { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+    { 0xD5D238A4ABE98068ULL,   109,   52 },
+    { 0x9F4F2726179A2245ULL,   136,   60 },
+    { 0xED63A231D4C4FB27ULL,   162,   68 },
+    { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+    { 0x83C7088E1AAB65DBULL,   216,   84 },
+    { 0xC45D1DF942711D9AULL,   242,   92 },
+    { 0x924D692CA61BE758ULL,   269,  100 },
+    { 0xDA01EE641A708DEAULL,   295,  108 },
+    { 0xA26DA3999AEF774AULL,   322,  116 },
+    { 0xF209787BB47D6B85ULL,   348,  124 },
+    { 0xB454E4A179DD1877ULL,   375,  132 },
+    { 0x865B86925B9BC5C2ULL,   402,  140 },
+    { 0xC83553C5C8965D3DULL,   428,  148 },
+    { 0x952AB45CFA97A0B3ULL,   455,  156 },
+    { 0xDE469FBD99A05FE3ULL,   481,  164 },
+    { 0xA59BC234DB398C25ULL,   508,  172 },
+    { 0xF6C69A72A3989F5CULL,   534,  180 },
+    { 0xB7DCBF5354E9BECEULL,   561,  188 },
+    { 0x88FCF317F22241E2ULL,   588,  196 },
+    { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+    { 0x98165AF37B2153DFULL,   641,  212 },
+    { 0xE2A0B5DC971F303AULL,   667,  220 },
+    { 0xA8D9D1535CE3B396ULL,   694,  228 },
+    { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+    { 0xBB764C4CA7A44410ULL,   747,  244 },
+    { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+    { 0xD01FEF10A657842CULL,   800,  260 },
+    { 0x9B10A4E5E9913129ULL,   827,  268 },
+    { 0xE7109BFBA19C0C9DULL,   853,  276 },
+    { 0xAC2820D9623BF429ULL,   880,  284 },
+    { 0x80444B5E7AA7CF85ULL,   907,  292 },
+    { 0xBF21E44003ACDD2DULL,   933,  300 },
+    { 0x8E679C2F5E44FF8FULL,   960,  308 },
+    { 0xD433179D9C8CB841ULL,   986,  316 },
+    { 0x9E19DB92B4E31BA9ULL,  1013,  324 },
+};
+
+static constexpr i32 grisu_alpha = -60;
+
+inline cached_power cached_power_for(i32 e) {
+    i32 f = grisu_alpha - e - 1;
+    i32 k = (f * 78913) / (1 << 18) + (f > 0);
+    u32 index = (u32)(300 + k + 7) / 8;
+    return cached_powers[index];
+}
+
+inline u32 largest_pow10(u32 n, u32& pow10) {
+    u32 digits = 10;
+    pow10 = 1000000000;
+    while(digits > 1 && n < pow10) {
+        pow10 /= 10;
+        digits--;
+    }
+    return digits;
+}
+
+inline void grisu_round(char* buf, u32 len, u64 dist, u64 delta, u64 rest, u64 ten_k) {
+    while(rest < dist && delta - rest >= ten_k
+          && (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+        buf[len - 1]--;
+        rest += ten_k;
+    }
+}
+
+inline void grisu_digits(char* buf, u32& len, i32& exp10, diyfp m_minus, diyfp w, diyfp m_plus) {
+    u64 delta = diyfp::sub(m_plus, m_minus).f;
+    u64 dist = diyfp::sub(m_plus, w).f;
+    diyfp one(1ULL << -m_plus.e, m_plus.e);
+
+    u32 p1 = (u32)(m_plus.f >> -one.e);
+    u64 p2 = m_plus.f & (one.f - 1);
+
+    u32 pow10;
+    u32 n = largest_pow10(p1, pow10);
+    while(n > 0) {
+        u32 d = p1 / pow10;
+        p1 %= pow10;
+        buf[len++] = (char)('0' + d);
+        n--;
+        u64 rest = ((u64)p1 << -one.e) + p2;
+        if(rest <= delta) {
+            exp10 += n;
+            grisu_round(buf, len, dist, delta, rest, (u64)pow10 << -one.e);
+            return;
+        }
+        pow10 /= 10;
+    }
+
+    i32 m = 0;
+    while(true) {
+        p2 *= 10;
+        buf[len++] = (char)('0' + (p2 >> -one.e));
+        p2 &= one.f - 1;
+        m++;
+        delta *= 10;
+        dist *= 10;
+        if(p2 <= delta) break;
+    }
+    exp10 -= m;
+    grisu_round(buf, len, dist, delta, p2, one.f);
+}
+
+// Shortest digits of a finite positive value with `mantissa_bits` explicit
+// mantissa bits; value == digits * 10^exp10.
+inline u32 grisu2(char* buf, i32& exp10, u64 bits, u32 mantissa_bits, i32 bias) {
+    u64 hidden = 1ULL << mantissa_bits;
+    u64 fraction = bits & (hidden - 1);
+    u64 biased = bits >> mantissa_bits;
+
+    diyfp v = biased == 0 ? diyfp(fraction, 1 - bias) : diyfp(fraction + hidden, (i32)biased - bias);
+    bool lower_closer = fraction == 0 && biased > 1;
+    diyfp m_plus(2 * v.f + 1, v.e - 1);
+    diyfp m_minus = lower_closer ? diyfp(4 * v.f - 1, v.e - 2) : diyfp(2 * v.f - 1, v.e - 1);
+
+    diyfp w_plus = diyfp::normalize(m_plus);
+    diyfp w_minus = diyfp::normalize_to(m_minus, w_plus.e);
+    diyfp w_v = diyfp::normalize(v);
+
+    cached_power cached = cached_power_for(w_plus.e);
+    diyfp c(cached.f, cached.e);
+    diyfp w = diyfp::mul(w_v, c);
+    diyfp lo = diyfp::mul(w_minus, c);
+    diyfp hi = diyfp::mul(w_plus, c);
+
+    u32 len = 0;
+    exp10 = -cached.k;
+    grisu_digits(buf, len, exp10, diyfp(lo.f + 1, lo.e), w, diyfp(hi.f - 1, hi.e));
+    return len;
+}
+
+// Lays out `len` digits (already at `out`) with decimal exponent `exp10`:
+// positional for 1e-5 < |v| < 1e16, scientific otherwise.
+inline u32 place_decimal_point(char* out, u32 len, i32 exp10) {
+    i32 k = (i32)len;
+    i32 n = k + exp10;
+
+    if(k <= n && n <= 16) {
+        for(i32 i = k; i < n; i++) out[i] = '0';
+        out[n] = '.';
+        out[n + 1] = '0';
+        return (u32)n + 2;
+    }
+    if(0 < n && n <= 16) {
+        for(i32 i = k; i > n; i--) out[i] = out[i - 1];
+        out[n] = '.';
+        return len + 1;
+    }
+    if(-5 < n && n <= 0) {
+        u32 shift = (u32)(2 - n);
+        for(i32 i = k - 1; i >= 0; i--) out[i + shift] = out[i];
+        out[0] = '0';
+        out[1] = '.';
+        for(u32 i = 2; i < shift; i++) out[i] = '0';
+        return shift + len;
+    }
+
+    u32 pos = 1;
+    if(k > 1) {
+        for(i32 i = k; i > 1; i--) out[i] = out[i - 1];
+        out[1] = '.';
+        pos = len + 1;
+    }
+    out[pos++] = 'e';
+    i32 e = n - 1;
+    if(e < 0) {
+        out[pos++] = '-';
+        e = -e;
+    }
+    return pos + format_unsigned(out + pos, (u32)e);
+}
+
+inline u32 format_special(char* out, bool negative, bool nan) {
+    u32 n = 0;
+    if(nan) {
+        out[0] = 'n'; out[1] = 'a'; out[2] = 'n';
+        return 3;
+    }
+    if(negative) out[n++] = '-';
+    out[n++] = 'i'; out[n++] = 'n'; out[n++] = 'f';
+    return n;
+}
+
+// Minimal fixed-width big integer for exact fixed-point formatting.
+struct bignum {
+    static constexpr u32 max_limbs = 40;
+    u32 limb[max_limbs];
+    u32 n;
+
+    bignum(u64 value) : n(0) {
+        while(value) {
+            limb[n++] = (u32)value;
+            value >>= 32;
+        }
+    }
+
+    bool is_zero() const { return n == 0; }
+
+    void trim() {
+        while(n > 0 && limb[n - 1] == 0) n--;
+    }
+
+    void shift_left(u32 bits) {
+        u32 words = bits / 32;
+        u32 rem = bits % 32;
+        if(n == 0) return;
+        limb[n] = 0;
+        for(i32 i = (i32)n; i >= 0; i--) {
+            u32 hi = limb[i] << rem;
+            u32 lo = (rem && i > 0) ? limb[i - 1] >> (32 - rem) : 0;
+            limb[i + words] = hi | lo;
+        }
+        for(u32 i = 0; i < words; i++) limb[i] = 0;
+        n += words + 1;
+        trim();
+    }
+
+    void mul_small(u32 m) {
+        u64 carry = 0;
+        for(u32 i = 0; i < n; i++) {
+            u64 t = (u64)limb[i] * m + carry;
+            limb[i] = (u32)t;
+            carry = t >> 32;
+        }
+        if(carry) limb[n++] = (u32)carry;
+    }
+
+    u32 divmod_small(u32 d) {
+        u64 rem = 0;
+        for(i32 i = (i32)n - 1; i >= 0; i--) {
+            u64 cur = (rem << 32) | limb[i];
+            limb[i] = (u32)(cur / d);
+            rem = cur % d;
+        }
+        trim();
+        return (u32)rem;
+    }
+
+    u32 bit(u32 index) const {
+        u32 w = index / 32;
+        return w < n ? (limb[w] >> (index % 32)) & 1 : 0;
+    }
+
+    // Removes and returns the bits at and above `s` (assumed to fit in u32).
+    u32 take_high(u32 s) {
+        u32 w = s / 32;
+        u32 r = s % 32;
+        if(w >= n) return 0;
+        u64 high = (u64)limb[w] >> r;
+        if(w + 1 < n) high |= (u64)limb[w + 1] << (32 - r);
+        limb[w] &= r ? (1u << r) - 1 : 0;
+        for(u32 i = w + 1; i < n; i++) limb[i] = 0;
+        trim();
+        return (u32)high;
+    }
+
+    // Compares against 2^(s - 1): -1, 0 or 1.
+    i32 compare_half(u32 s) const {
+        u32 top = s - 1;
+        u32 w = top / 32;
+        if(n > w + 1) return 1;
+        if(n < w + 1) return -1;
+        u32 half_bit = 1u << (top % 32);
+        if(limb[w] > half_bit) return 1;
+        if(limb[w] < half_bit) return -1;
+        for(u32 i = 0; i < w; i++) {
+            if(limb[i]) return 1;
+        }
+        return 0;
+    }
+};
+
+}
+
+u32 format_u64(char* out, u64 value) { return detail::format_unsigned(out, value); }
+u32 format_u32(char* out, u32 value) { return detail::format_unsigned(out, value); }
+
+u32 format_i64(char* out, i64 value) {
+    if(value < 0) {
+        out[0] = '-';
+        return 1 + detail::format_unsigned(out + 1, 0 - (u64)value);
+    }
+    return detail::format_unsigned(out, (u64)value);
+}
+
+u32 format_i32(char* out, i32 value) {
+    if(value < 0) {
+        out[0] = '-';
+        return 1 + detail::format_unsigned(out + 1, 0u - (u32)value);
+    }
+    return detail::format_unsigned(out, (u32)value);
+}
+
+// Base 2, 8 or 16 (lowercase), no prefix.
+u32 format_radix(char* out, u64 value, u32 base, bool upper = false) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    u32 shift = base == 16 ? 4 : base == 8 ? 3 : 1;
+    u32 n = 1;
+    for(u64 v = value >> shift; v; v >>= shift) n++;
+    for(u32 i = n; i > 0; i--) {
+        out[i - 1] = digits[value & (base - 1)];
+        value >>= shift;
+    }
+    return n;
+}
+
+// Shortest representation that parses back to exactly `value`.
+u32 format_f64(char* out, f64 value) {
+    u64 bits;
+    memcpy_simple(&bits, &value, sizeof(bits));
+    bool negative = bits >> 63;
+    bits &= ~(1ULL << 63);
+    if((bits >> 52) == 0x7FF) return detail::format_special(out, negative, (bits & ((1ULL << 52) - 1)) != 0);
+
+    u32 n = 0;
+    if(negative) out[n++] = '-';
+    if(bits == 0) {
+        out[n] = '0'; out[n + 1] = '.'; out[n + 2] = '0';
+        return n + 3;
+    }
+    i32 exp10;
+    u32 len = detail::grisu2(out + n, exp10, bits, 52, 1075);
+    return n + detail::place_decimal_point(out + n, len, exp10);
+}
+
+u32 format_f32(char* out, f32 value) {
+    u32 bits;
+    memcpy_simple(&bits, &value, sizeof(bits));
+    bool negative = bits >> 31;
+    bits &= 0x7FFFFFFFu;
+    if((bits >> 23) == 0xFF) return detail::format_special(out, negative, (bits & 0x7FFFFFu) != 0);
+
+    u32 n = 0;
+    if(negative) out[n++] = '-';
+    if(bits == 0) {
+        out[n] = '0'; out[n + 1] = '.'; out[n + 2] = '0';
+        return n + 3;
+    }
+    i32 exp10;
+    u32 len = detail::grisu2(out + n, exp10, bits, 23, 150);
+    return n + detail::place_decimal_point(out + n, len, exp10);
+}
+
+// Exactly rounded (half to even) fixed-point output with `precision` digits
+// after the point, capped at format_precision_max.
+u32 format_fixed(char* out, f64 value, u32 precision) {
+    if(precision > format_precision_max) precision = format_precision_max;
+
+    u64 bits;
+    memcpy_simple(&bits, &value, sizeof(bits));
+    bool negative = bits >> 63;
+    u64 biased = (bits >> 52) & 0x7FF;
+    u64 fraction = bits & ((1ULL << 52) - 1);
+    if(biased == 0x7FF) return detail::format_special(out, negative, fraction != 0);
+
+    u64 mantissa = biased ? fraction | (1ULL << 52) : fraction;
+    i32 exp2 = biased ? (i32)biased - 1075 : -1074;
+
+    // Digits are produced without the point into `digits`, integer part first.
+    char digits[format_fixed_max];
+    u32 int_len = 0;
+    u32 len = 0;
+
+    if(exp2 >= 0) {
+        detail::bignum ip(mantissa);
+        ip.shift_left((u32)exp2);
+        char rev[format_fixed_max];
+        u32 r = 0;
+        while(!ip.is_zero()) {
+            u32 chunk = ip.divmod_small(1000000000);
+            for(u32 i = 0; i < 9; i++) {
+                rev[r++] = (char)('0' + chunk % 10);
+                chunk /= 10;
+            }
+        }
+        while(r > 1 && rev[r - 1] == '0') r--;
+        if(r == 0) rev[r++] = '0';
+        while(r > 0) digits[len++] = rev[--r];
+        int_len = len;
+        for(u32 i = 0; i < precision; i++) digits[len++] = '0';
+    } else {
+        u32 s = (u32)-exp2;
+        u64 ip = s < 64 ? mantissa >> s : 0;
+        detail::bignum frac(s < 64 ? mantissa & ((1ULL << s) - 1) : mantissa);
+        len = detail::format_unsigned(digits, ip);
+        int_len = len;
+        for(u32 i = 0; i < precision; i++) {
+            frac.mul_small(10);
+            digits[len++] = (char)('0' + frac.take_high(s));
+        }
+
+        i32 cmp = frac.is_zero() ? -1 : frac.compare_half(s);
+        bool round_up = cmp > 0 || (cmp == 0 && ((digits[len - 1] - '0') & 1));
+        if(round_up) {
+            i32 i = (i32)len - 1;
+            while(i >= 0 && digits[i] == '9') digits[i--] = '0';
+            if(i >= 0) {
+                digits[i]++;
+            } else {
+                for(u32 j = len; j > 0; j--) digits[j] = digits[j - 1];
+                digits[0] = '1';
+                len++;
+                int_len++;
+            }
+        }
+    }
+
+    u32 n = 0;
+    if(negative) out[n++] = '-';
+    for(u32 i = 0; i < int_len; i++) out[n++] = digits[i];
+    if(precision > 0) {
+        out[n++] = '.';
+        for(u32 i = int_len; i < len; i++) out[n++] = digits[i];
+    }
+    return n;
+}
+
+struct radix_value {
+    u64 value;
+    u32 base;
+    bool upper;
+};
+
+radix_value hex(u64 value, bool upper = false) { return radix_value{value, 16, upper}; }
+radix_value oct(u64 value) { return radix_value{value, 8, false}; }
+radix_value bin(u64 value) { return radix_value{value, 2, false}; }
+
+struct fixed_value {
+    f64 value;
+    u32 precision;
+};
+
+fixed_value fixed(f64 value, u32 precision) { return fixed_value{value, precision}; }
+
+#ifndef RAZ_OSTREAM_BUFFER_SIZE
+#define RAZ_OSTREAM_BUFFER_SIZE 4096
+#endif
+
+enum class buffer_mode : u8 {
+    none,
+    line,
+    full
+};
+
+class ostream {
+private:
+    char buf[RAZ_OSTREAM_BUFFER_SIZE];
+    u32 pos;
+    buffer_mode mode;
+    i32 fd;
+
+    void write_raw(const char* str, u32 len) {
+        long n = sys::write(fd, str, len);
+        RAZ_STAT(stats.ostreams.record_io(n));
+        (void)n;
+    }
+
+    void write_char(char c) {
+        buf[pos++] = c;
+        if(pos == RAZ_OSTREAM_BUFFER_SIZE || mode == buffer_mode::none) flush();
+    }
+
+    void write_string(const char* str, u32 len) {
+        if(len >= RAZ_OSTREAM_BUFFER_SIZE) {
+            flush();
+            write_raw(str, len);
+            return;
+        }
+        if(pos + len > RAZ_OSTREAM_BUFFER_SIZE) flush();
+        for(u32 i = 0; i < len; i++) buf[pos + i] = str[i];
+        pos += len;
+        if(mode == buffer_mode::none) flush();
+    }
+
+    void write_string(const char* str) {
+        write_string(str, strlen_simple(str));
+    }
+
+public:
+    ostream(buffer_mode initial_mode = buffer_mode::line) : pos(0), mode(initial_mode), fd(1) {}
+
+    // Stream over any open descriptor (a file, a pipe); not closed on destruction.
+    explicit ostream(i32 out_fd, buffer_mode initial_mode = buffer_mode::full) : pos(0), mode(initial_mode), fd(out_fd) {}
+
+    ostream(const ostream&) = delete;
+    ostream& operator=(const ostream&) = delete;
+
+    ~ostream() {
+        flush();
+    }
+
+    // Formats straight into the buffer; `max_len` bounds what `format` writes.
+    template<typename F>
+    void emit(u32 max_len, F format) {
+        if(max_len > RAZ_OSTREAM_BUFFER_SIZE) {
+            heap_allocator heap;
+            char* tmp = (char*)heap.allocate(max_len);
+            write_string(tmp, format(tmp));
+            heap.deallocate(tmp, max_len);
+            return;
+        }
+        if(pos + max_len > RAZ_OSTREAM_BUFFER_SIZE) flush();
+        pos += format(buf + pos);
+        if(mode == buffer_mode::none) flush();
+    }
+
+    void flush() {
+        if(pos > 0) {
+            write_raw(buf, pos);
+            pos = 0;
+        }
+    }
+
+    void set_mode(buffer_mode new_mode) {
+        mode = new_mode;
+        if(mode == buffer_mode::none) flush();
+    }
+
+    buffer_mode get_mode() const { return mode; }
+    u32 pending() const { return pos; }
+
+    ostream& operator<<(const char* str) { write_string(str); return *this; }
+    template<typename A>
+    ostream& operator<<(const basic_string<A>& str) { write_string(str.c_str(), str.length()); return *this; }
+    ostream& operator<<(string_view str) { write_string(str.data(), str.length()); return *this; }
+    ostream& operator<<(char c) { write_char(c); return *this; }
+    ostream& operator<<(bool b) { write_string(b ? "true" : "false"); return *this; }
+
+    ostream& operator<<(const endl_t&) {
+        write_char('\n');
+        if(mode == buffer_mode::line) flush();
+        return *this;
+    }
+
+    ostream& operator<<(i32 num) { emit(format_int_max, [num](char* out) { return format_i32(out, num); }); return *this; }
+    ostream& operator<<(u32 num) { emit(format_int_max, [num](char* out) { return format_u32(out, num); }); return *this; }
+    ostream& operator<<(i64 num) { emit(format_int_max, [num](char* out) { return format_i64(out, num); }); return *this; }
+    ostream& operator<<(u64 num) { emit(format_int_max, [num](char* out) { return format_u64(out, num); }); return *this; }
+    ostream& operator<<(long num) { return *this << (i64)num; }
+    ostream& operator<<(unsigned long num) { return *this << (u64)num; }
+    ostream& operator<<(f64 num) { emit(format_float_max, [num](char* out) { return format_f64(out, num); }); return *this; }
+    ostream& operator<<(f32 num) { emit(format_float_max, [num](char* out) { return format_f32(out, num); }); return *this; }
+
+    ostream& operator<<(radix_value v) {
+        emit(format_int_max * 3, [v](char* out) { return format_radix(out, v.value, v.base, v.upper); });
+        return *this;
+    }
+
+    ostream& operator<<(fixed_value v) {
+        emit(format_fixed_max, [v](char* out) { return format_fixed(out, v.value, v.precision); });
+        return *this;
+    }
+};
+
+static ostream cout;
+
+void print(const char* str) { cout << str; }
+void print(const string& str) { cout << str; }
+void print(string_view str) { cout << str; }
+void print(i32 num) { cout << num; }
+void print(u32 num) { cout << num; }
+void print(i64 num) { cout << num; }
+void print(u64 num) { cout << num; }
+void print(f64 num) { cout << num; }
+void print(bool b) { cout << b; }
+
+void println(const char* str) { cout << str << endl; }
+void println(const string& str) { cout << str << endl; }
+void println(string_view str) { cout << str << endl; }
+void println(i32 num) { cout << num << endl; }
+void println(u32 num) { cout << num << endl; }
+void println(i64 num) { cout << num << endl; }
+void println(u64 num) { cout << num << endl; }
+void println(f64 num) { cout << num << endl; }
+void println(bool b) { cout << b << endl; }
+
+#ifndef RAZ_FORMAT_MAX_FIELDS
+#define RAZ_FORMAT_MAX_FIELDS 32
+#endif
+
+// One parsed piece of a format string: literal text followed by an optional
+// replacement field `{[index][:[[fill]align][sign][#][0][width][.precision][type]]}`.
+struct format_spec {
+    u16 literal_begin = 0;
+    u16 literal_len = 0;
+    u8 arg = 0;
+    char fill = ' ';
+    char align = 0;
+    char sign = '-';
+    bool alt = false;
+    bool zero = false;
+    u16 width = 0;
+    i16 precision = -1;
+    char type = 0;
+
+    static constexpr u8 no_arg = 0xFF;
+    static constexpr u8 bad_arg = 0xFE;
+};
+
+// Output target for formatters: writes up to `end`, counts everything.
+class format_sink {
+private:
+    char* cur;
+    char* end;
+    u32 total;
+
+public:
+    format_sink(char* out, u32 cap) : cur(out), end(out + cap), total(0) {}
+
+    void put(const char* str, u32 n) {
+        total += n;
+        u32 room = (u32)(end - cur);
+        if(n > room) n = room;
+        memcpy_simple(cur, str, n);
+        cur += n;
+    }
+
+    void put_fill(char c, u32 n) {
+        total += n;
+        u32 room = (u32)(end - cur);
+        if(n > room) n = room;
+        for(u32 i = 0; i < n; i++) cur[i] = c;
+        cur += n;
+    }
+
+    // Pads `body` to the field width; numbers with '0' pad after `prefix_len`
+    // chars (sign and base prefix).
+    void put_field(const char* body, u32 len, const format_spec& spec, char default_align, u32 prefix_len = 0) {
+        u32 pad = spec.width > len ? spec.width - len : 0;
+        if(pad == 0) {
+            put(body, len);
+            return;
+        }
+        if(spec.zero && spec.align == 0) {
+            put(body, prefix_len);
+            put_fill('0', pad);
+            put(body + prefix_len, len - prefix_len);
+            return;
+        }
+        char align = spec.align ? spec.align : default_align;
+        u32 before = align == '>' ? pad : align == '^' ? pad / 2 : 0;
+        put_fill(spec.fill, before);
+        put(body, len);
+        put_fill(spec.fill, pad - before);
+    }
+
+    u32 size() const { return total; }
+};
+
+enum class format_kind : u8 {
+    integer,
+    floating,
+    text,
+    character,
+    boolean,
+    pointer,
+    custom
+};
+
+// Customization point. A specialization provides `kind`, an upper bound on
+// its output with `max_size` (padding excluded) and `write`.
+template<typename T>
+struct formatter {
+    static constexpr format_kind kind = format_kind::custom;
+};
+
+namespace detail {
+
+template<typename T>
+struct int_formatter {
+    static constexpr format_kind kind = format_kind::integer;
+    static constexpr bool is_signed = (T)-1 < (T)0;
+
+    static u32 max_size(T, const format_spec&) { return 2 + 64 + 1; }
+
+    static void write(format_sink& sink, T value, const format_spec& spec) {
+        char tmp[2 + 64 + 1];
+        u32 n = 0;
+        bool negative = is_signed && (i64)value < 0;
+        u64 magnitude = negative ? 0 - (u64)value : (u64)value;
+        if(negative) {
+            tmp[n++] = '-';
+        } else if(spec.sign == '+' || spec.sign == ' ') {
+            tmp[n++] = spec.sign;
+        }
+        u32 base = spec.type == 'x' || spec.type == 'X' ? 16 : spec.type == 'b' ? 2 : spec.type == 'o' ? 8 : 10;
+        if(spec.alt && base != 10) {
+            tmp[n++] = '0';
+            tmp[n++] = base == 16 ? spec.type : base == 2 ? 'b' : 'o';
+        }
+        u32 prefix = n;
+        n += base == 10 ? format_u64(tmp + n, magnitude) : format_radix(tmp + n, magnitude, base, spec.type == 'X');
+        sink.put_field(tmp, n, spec, '>', prefix);
+    }
+};
+
+template<typename T>
+struct float_formatter {
+    static constexpr format_kind kind = format_kind::floating;
+
+    static u32 max_size(T value, const format_spec& spec) {
+        if(spec.precision < 0 && spec.type != 'f') return format_float_max + 1;
+        f64 wide = (f64)value;
+        u64 bits;
+        memcpy_simple(&bits, &wide, sizeof(bits));
+        i32 exp = (i32)((bits >> 52) & 0x7FF);
+        if(exp == 0x7FF) return format_float_max + 1;
+        // Integer digits from the binary exponent: log10(2) ~ 78913 / 2^18.
+        exp -= 1022;
+        u32 digits = exp > 0 ? (u32)(((u64)exp * 78913) >> 18) + 1 : 1;
+        u32 precision = spec.precision >= 0 ? (u32)spec.precision : 6;
+        if(precision > format_precision_max) precision = format_precision_max;
+        // Sign, rounding carry, and the decimal point.
+        return 3 + digits + precision;
+    }
+
+    static void write(format_sink& sink, T value, const format_spec& spec) {
+        char tmp[format_fixed_max + 1];
+        u32 n = 0;
+        bool negative = __builtin_signbit(value);
+        if(!negative && (spec.sign == '+' || spec.sign == ' ')) tmp[n++] = spec.sign;
+        if(spec.precision >= 0 || spec.type == 'f') {
+            n += format_fixed(tmp + n, value, spec.precision >= 0 ? (u32)spec.precision : 6);
+        } else if(sizeof(T) == sizeof(f32)) {
+            n += format_f32(tmp + n, (f32)value);
+        } else {
+            n += format_f64(tmp + n, (f64)value);
+        }
+        u32 prefix = (tmp[0] == '-' || tmp[0] == '+' || tmp[0] == ' ') ? 1 : 0;
+        sink.put_field(tmp, n, spec, '>', prefix);
+    }
+};
+
+struct text_formatter {
+    static constexpr format_kind kind = format_kind::text;
+
+    static u32 max_size(string_view value, const format_spec&) { return value.length(); }
+
+    static void write(format_sink& sink, string_view value, const format_spec& spec) {
+        u32 n = value.length();
+        if(spec.precision >= 0 && (u32)spec.precision < n) n = (u32)spec.precision;
+        sink.put_field(value.data(), n, spec, '<');
+    }
+};
+
+}
+
+template<> struct formatter<u8> : detail::int_formatter<u8> {};
+template<> struct formatter<i16> : detail::int_formatter<i16> {};
+template<> struct formatter<u16> : detail::int_formatter<u16> {};
+template<> struct formatter<i32> : detail::int_formatter<i32> {};
+template<> struct formatter<u32> : detail::int_formatter<u32> {};
+template<> struct formatter<long> : detail::int_formatter<long> {};
+template<> struct formatter<unsigned long> : detail::int_formatter<unsigned long> {};
+template<> struct formatter<i64> : detail::int_formatter<i64> {};
+template<> struct formatter<u64> : detail::int_formatter<u64> {};
+template<> struct formatter<f32> : detail::float_formatter<f32> {};
+template<> struct formatter<f64> : detail::float_formatter<f64> {};
+template<> struct formatter<string_view> : detail::text_formatter {};
+template<> struct formatter<const char*> : detail::text_formatter {};
+template<> struct formatter<char*> : detail::text_formatter {};
+template<typename A> struct formatter<basic_string<A>> : detail::text_formatter {};
+
+template<>
+struct formatter<char> {
+    static constexpr format_kind kind = format_kind::character;
+
+    static u32 max_size(char, const format_spec&) { return 1; }
+    static void write(format_sink& sink, char value, const format_spec& spec) { sink.put_field(&value, 1, spec, '<'); }
+};
+
+template<>
+struct formatter<bool> {
+    static constexpr format_kind kind = format_kind::boolean;
+
+    static u32 max_size(bool, const format_spec&) { return 5; }
+    static void write(format_sink& sink, bool value, const format_spec& spec) {
+        sink.put_field(value ? "true" : "false", value ? 4 : 5, spec, '<');
+    }
+};
+
+template<typename T>
+struct formatter<T*> {
+    static constexpr format_kind kind = format_kind::pointer;
+
+    static u32 max_size(T*, const format_spec&) { return 18; }
+    static void write(format_sink& sink, T* value, const format_spec& spec) {
+        char tmp[18] = {'0', 'x'};
+        u32 n = 2 + format_radix(tmp + 2, (u64)value, 16);
+        sink.put_field(tmp, n, spec, '>', 2);
+    }
+};
+
+namespace detail {
+
+// Not constexpr on purpose: reaching it while the format string is checked at
+// compile time makes the call ill-formed and names the problem.
+inline void format_string_error(const char*) {}
+
+// A field with no argument is a bug in the call, never in the data, so under
+// C++17, where it cannot fail to compile, it traps instead of printing "{?}".
+inline void format_missing_argument() { __builtin_trap(); }
+
+template<typename T> struct decay_format { using type = T; };
+template<typename T> struct decay_format<const T> { using type = typename decay_format<T>::type; };
+template<typename T> struct decay_format<T&> { using type = typename decay_format<T>::type; };
+template<typename T, u32 N> struct decay_format<T[N]> { using type = const T*; };
+
+template<typename T>
+using format_type = typename decay_format<T>::type;
+
+// Erased argument: pointer plus the two formatter entry points.
+struct format_arg {
+    const void* ptr;
+    u32 (*size)(const void*, const format_spec&);
+    void (*write)(format_sink&, const void*, const format_spec&);
+};
+
+template<typename T>
+format_arg make_format_arg(const T& value) {
+    using F = formatter<format_type<T>>;
+    format_arg arg;
+    arg.ptr = &value;
+    arg.size = [](const void* p, const format_spec& spec) -> u32 { return F::max_size(*(const T*)p, spec); };
+    arg.write = [](format_sink& sink, const void* p, const format_spec& spec) { F::write(sink, *(const T*)p, spec); };
+    return arg;
+}
+
+constexpr bool type_allowed(format_kind kind, char type) {
+    switch(type) {
+        case 0: return true;
+        case 'd': case 'x': case 'X': case 'b': case 'o': return kind == format_kind::integer || kind == format_kind::custom;
+        case 'f': return kind == format_kind::floating || kind == format_kind::custom;
+        case 's': return kind == format_kind::text || kind == format_kind::boolean || kind == format_kind::custom;
+        case 'c': return kind == format_kind::character || kind == format_kind::custom;
+        case 'p': return kind == format_kind::pointer || kind == format_kind::custom;
+        default: return false;
+    }
+}
+
+}
+
+// A format string checked against its argument types. With C++20 it is parsed
+// and validated at compile time; under C++17 the parse is constexpr and usually
+// folded, a field without an argument traps and other invalid fields print as
+// "{?}".
+template<typename... Args>
+class format_string {
+private:
+    static constexpr u32 arg_count = sizeof...(Args);
+    static constexpr format_kind kinds[arg_count + 1] = {formatter<detail::format_type<Args>>::kind..., format_kind::custom};
+
+    constexpr void add(u32 lit_begin, u32 lit_len, u8 arg) {
+        if(count == RAZ_FORMAT_MAX_FIELDS) {
+            detail::format_string_error("too many fields, raise RAZ_FORMAT_MAX_FIELDS");
+            return;
+        }
+        format_spec& s = specs[count++];
+        s.literal_begin = (u16)lit_begin;
+        s.literal_len = (u16)lit_len;
+        s.arg = arg;
+        literal_total += lit_len;
+    }
+
+    static constexpr bool is_align(char c) { return c == '<' || c == '>' || c == '^'; }
+
+    // Parses the field body starting after '{'; returns the index of its '}'.
+    constexpr u32 parse_field(u32 i, u32 lit_begin, u32 lit_len, u32& next_auto) {
+        u32 arg = 0;
+        if(i < len && str[i] >= '0' && str[i] <= '9') {
+            while(i < len && str[i] >= '0' && str[i] <= '9') arg = arg * 10 + (u32)(str[i++] - '0');
+        } else {
+            arg = next_auto++;
+        }
+        if(arg >= arg_count) {
+            detail::format_missing_argument();
+            arg = format_spec::bad_arg;
+        }
+        add(lit_begin, lit_len, (u8)arg);
+        if(count == 0) return len;
+        format_spec& s = specs[count - 1];
+
+        if(i < len && str[i] == ':') {
+            i++;
+            if(i + 1 < len && is_align(str[i + 1]) && str[i] != '}') {
+                s.fill = str[i];
+                s.align = str[i + 1];
+                i += 2;
+            } else if(i < len && is_align(str[i])) {
+                s.align = str[i++];
+            }
+            if(i < len && (str[i] == '+' || str[i] == '-' || str[i] == ' ')) s.sign = str[i++];
+            if(i < len && str[i] == '#') {
+                s.alt = true;
+                i++;
+            }
+            if(i < len && str[i] == '0') {
+                s.zero = true;
+                i++;
+            }
+            while(i < len && str[i] >= '0' && str[i] <= '9') s.width = (u16)(s.width * 10 + (str[i++] - '0'));
+            if(i < len && str[i] == '.') {
+                i++;
+                s.precision = 0;
+                while(i < len && str[i] >= '0' && str[i] <= '9') s.precision = (i16)(s.precision * 10 + (str[i++] - '0'));
+            }
+            if(i < len && str[i] != '}') s.type = str[i++];
+        }
+        if(i >= len || str[i] != '}') {
+            detail::format_string_error("expected '}' to close the field");
+            s.arg = format_spec::bad_arg;
+            while(i < len && str[i] != '}') i++;
+            return i;
+        }
+        if(s.arg != format_spec::bad_arg && !detail::type_allowed(kinds[s.arg], s.type)) {
+            detail::format_string_error("presentation type does not match the argument");
+            s.arg = format_spec::bad_arg;
+        }
+        if(s.precision > (i16)format_precision_max) s.precision = (i16)format_precision_max;
+        return i;
+    }
+
+public:
+    const char* str;
+    u32 len;
+    format_spec specs[RAZ_FORMAT_MAX_FIELDS];
+    u32 count;
+    u32 literal_total;
+
+    template<u32 N>
+    RAZ_CONSTEVAL format_string(const char (&text)[N]) : str(text), len(N - 1), specs(), count(0), literal_total(0) {
+        u32 lit_begin = 0;
+        u32 next_auto = 0;
+        u32 i = 0;
+        while(i < len) {
+            char c = str[i];
+            if(c == '{' && i + 1 < len && str[i + 1] == '{') {
+                add(lit_begin, i + 1 - lit_begin, format_spec::no_arg);
+                i += 2;
+                lit_begin = i;
+            } else if(c == '}' && i + 1 < len && str[i + 1] == '}') {
+                add(lit_begin, i + 1 - lit_begin, format_spec::no_arg);
+                i += 2;
+                lit_begin = i;
+            } else if(c == '{') {
+                i = parse_field(i + 1, lit_begin, i - lit_begin, next_auto) + 1;
+                lit_begin = i;
+            } else if(c == '}') {
+                detail::format_string_error("unmatched '}'");
+                i++;
+            } else {
+                i++;
+            }
+        }
+        if(lit_begin < len) add(lit_begin, len - lit_begin, format_spec::no_arg);
+    }
+};
+
+template<typename... Args>
+using format_string_for = format_string<typename type_identity<Args>::type...>;
+
+namespace detail {
+
+// Upper bound on the output: literal text plus every field at its widest.
+inline u32 format_bound(const char*, u32 literal_total, const format_spec* specs, u32 count, const format_arg* args) {
+    u32 bound = literal_total;
+    for(u32 i = 0; i < count; i++) {
+        const format_spec& s = specs[i];
+        if(s.arg == format_spec::no_arg) continue;
+        if(s.arg == format_spec::bad_arg) {
+            bound += 3;
+            continue;
+        }
+        u32 n = args[s.arg].size(args[s.arg].ptr, s);
+        bound += n > s.width ? n : s.width;
+    }
+    return bound;
+}
+
+inline void format_run(format_sink& sink, const char* str, const format_spec* specs, u32 count, const format_arg* args) {
+    for(u32 i = 0; i < count; i++) {
+        const format_spec& s = specs[i];
+        sink.put(str + s.literal_begin, s.literal_len);
+        if(s.arg == format_spec::no_arg) continue;
+        if(s.arg == format_spec::bad_arg) {
+            sink.put("{?}", 3);
+            continue;
+        }
+        args[s.arg].write(sink, args[s.arg].ptr, s);
+    }
+}
+
+}
+
+// Writes at most `cap` bytes (no terminator); returns the full length, so a
+// result larger than `cap` means the output was cut.
+template<typename... Args>
+u32 format_to(char* out, u32 cap, format_string_for<Args...> fmt, const Args&... args) {
+    detail::format_arg packed[sizeof...(Args) + 1] = {detail::make_format_arg(args)...};
+    format_sink sink(out, cap);
+    detail::format_run(sink, fmt.str, fmt.specs, fmt.count, packed);
+    return sink.size();
+}
+
+template<typename... Args>
+string format(format_string_for<Args...> fmt, const Args&... args) {
+    detail::format_arg packed[sizeof...(Args) + 1] = {detail::make_format_arg(args)...};
+    u32 bound = detail::format_bound(fmt.str, fmt.literal_total, fmt.specs, fmt.count, packed);
+    string result;
+    result.resize(bound);
+    format_sink sink(&result[0], bound);
+    detail::format_run(sink, fmt.str, fmt.specs, fmt.count, packed);
+    result.resize(sink.size());
+    return result;
+}
+
+// Formats straight into cout's buffer in one pass.
+template<typename... Args>
+void print_fmt(format_string_for<Args...> fmt, const Args&... args) {
+    detail::format_arg packed[sizeof...(Args) + 1] = {detail::make_format_arg(args)...};
+    u32 bound = detail::format_bound(fmt.str, fmt.literal_total, fmt.specs, fmt.count, packed);
+    cout.emit(bound, [&](char* out) {
+        format_sink sink(out, bound);
+        detail::format_run(sink, fmt.str, fmt.specs, fmt.count, packed);
+        return sink.size();
+    });
+}
+
+template<typename... Args>
+void println_fmt(format_string_for<Args...> fmt, const Args&... args) {
+    print_fmt<Args...>(fmt, args...);
+    cout << endl;
+}
+
+#ifndef RAZ_ASYNC_BUFFER_SIZE
+#define RAZ_ASYNC_BUFFER_SIZE (64u << 10)
+#endif
+
+#ifndef RAZ_ASYNC_MAX_BUFFERS
+#define RAZ_ASYNC_MAX_BUFFERS 16
+#endif
+
+// Output sink that never blocks on the device while a buffer is free. Full
+// buffers are submitted to io_uring and filling continues in the next one;
+// completions are reaped by poll() or whenever a buffer is needed. Regular
+// files get explicit offsets so several writes can be in flight; pipes,
+// sockets and O_APPEND files keep one write in flight and queue the other full
+// buffers behind it to preserve order. Without
+// io_uring the full buffers are gathered into a single blocking writev.
+// Single-threaded; the descriptor is not closed.
+class async_writer {
+private:
+    struct buffer {
+        char* data;
+        u32 len;
+        u32 done;
+        u64 offset;
+        bool in_flight;
+        sys::iovec iov;
+    };
+
+    buffer bufs[RAZ_ASYNC_MAX_BUFFERS];
+    u32 count;
+    u32 size;
+    u32 current;
+    u32 in_flight;
+    i32 fd;
+    i32 err;
+    bool seekable;
+    bool synced;
+    u64 next_offset;
+    char* memory;
+
+    // Non-seekable descriptors: handed-off buffers in write order; only the
+    // first is submitted.
+    u32 queue[RAZ_ASYNC_MAX_BUFFERS];
+    u32 queue_head;
+    u32 queue_len;
+
+    i32 ring_fd;
+    u8* sq_map;
+    u64 sq_map_len;
+    u8* cq_map;
+    u64 cq_map_len;
+    sys::io_uring_sqe* sqes;
+    u64 sqes_len;
+    u32* sq_tail;
+    u32* sq_array;
+    u32 sq_mask;
+    u32* cq_head;
+    u32* cq_tail;
+    u32 cq_mask;
+    sys::io_uring_cqe* cqes;
+
+    bool setup_ring() {
+        sys::io_uring_params params = {};
+        i32 rfd = sys::io_uring_setup(count * 2, &params);
+        if(rfd < 0) return false;
+        sq_map_len = params.sq_off.array + params.sq_entries * sizeof(u32);
+        cq_map_len = params.cq_off.cqes + params.cq_entries * sizeof(sys::io_uring_cqe);
+        bool single = params.features & sys::ioring_feat_single_mmap;
+        if(single && cq_map_len > sq_map_len) sq_map_len = cq_map_len;
+        sqes_len = params.sq_entries * sizeof(sys::io_uring_sqe);
+
+        i32 prot = sys::prot_read | sys::prot_write;
+        i32 flags = sys::map_shared | sys::map_populate;
+        sq_map = (u8*)sys::mmap(nullptr, sq_map_len, prot, flags, rfd, sys::ioring_off_sq_ring);
+        cq_map = single ? sq_map : (u8*)sys::mmap(nullptr, cq_map_len, prot, flags, rfd, sys::ioring_off_cq_ring);
+        sqes = (sys::io_uring_sqe*)sys::mmap(nullptr, sqes_len, prot, flags, rfd, sys::ioring_off_sqes);
+        if(!sq_map || !cq_map || !sqes) {
+            if(sq_map) sys::munmap(sq_map, sq_map_len);
+            if(cq_map && !single) sys::munmap(cq_map, cq_map_len);
+            if(sqes) sys::munmap(sqes, sqes_len);
+            sys::close(rfd);
+            return false;
+        }
+        if(single) cq_map_len = 0;
+
+        sq_tail = (u32*)(sq_map + params.sq_off.tail);
+        sq_array = (u32*)(sq_map + params.sq_off.array);
+        sq_mask = *(u32*)(sq_map + params.sq_off.ring_mask);
+        cq_head = (u32*)(cq_map + params.cq_off.head);
+        cq_tail = (u32*)(cq_map + params.cq_off.tail);
+        cq_mask = *(u32*)(cq_map + params.cq_off.ring_mask);
+        cqes = (sys::io_uring_cqe*)(cq_map + params.cq_off.cqes);
+        ring_fd = rfd;
+        return true;
+    }
+
+    void close_ring() {
+        if(ring_fd < 0) return;
+        sys::munmap(sqes, sqes_len);
+        if(cq_map_len) sys::munmap(cq_map, cq_map_len);
+        sys::munmap(sq_map, sq_map_len);
+        sys::close(ring_fd);
+        ring_fd = -1;
+    }
+
+    // Queues the unwritten part of buffer `i` as one WRITEV and enters the ring.
+    void submit(u32 i) {
+        buffer& b = bufs[i];
+        b.iov.base = b.data + b.done;
+        b.iov.len = b.len - b.done;
+
+        u32 tail = *sq_tail;
+        u32 slot = tail & sq_mask;
+        sys::io_uring_sqe& sqe = sqes[slot];
+        sqe = sys::io_uring_sqe();
+        sqe.opcode = sys::ioring_op_writev;
+        sqe.fd = fd;
+        sqe.off = seekable ? b.offset + b.done : 0;
+        sqe.addr = (u64)&b.iov;
+        sqe.len = 1;
+        sqe.user_data = i;
+        sq_array[slot] = slot;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        if(!b.in_flight) in_flight++;
+        b.in_flight = true;
+        long ret = sys::io_uring_enter(ring_fd, 1, 0, 0);
+        RAZ_STAT(stats.ostreams.record_io(ret < 0 ? ret : (long)b.iov.len));
+        if(ret < 0) {
+            if(!err) err = (i32)ret;
+            finish(i);
+        }
+    }
+
+    void release(buffer& b) {
+        b.len = 0;
+        b.done = 0;
+        if(b.in_flight) in_flight--;
+        b.in_flight = false;
+    }
+
+    // Queues buffer `i` behind the write in progress, submitting it at once
+    // when there is none.
+    void enqueue(u32 i) {
+        queue[(queue_head + queue_len) % RAZ_ASYNC_MAX_BUFFERS] = i;
+        queue_len++;
+        bufs[i].in_flight = true;
+        in_flight++;
+        if(queue_len == 1) submit(i);
+    }
+
+    // Releases buffer `i` and, for an ordered descriptor, submits the next one.
+    void finish(u32 i) {
+        release(bufs[i]);
+        if(seekable || queue_len == 0 || queue[queue_head] != i) return;
+        queue_head = (queue_head + 1) % RAZ_ASYNC_MAX_BUFFERS;
+        queue_len--;
+        if(queue_len) submit(queue[queue_head]);
+    }
+
+    // Handles every posted completion, first waiting for one when asked.
+    u32 reap(bool wait) {
+        u32 head = *cq_head;
+        if(wait && head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+            sys::io_uring_enter(ring_fd, 0, 1, sys::ioring_enter_getevents);
+        }
+        u32 tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        u32 reaped = 0;
+        for(; head != tail; head++) {
+            sys::io_uring_cqe cqe = cqes[head & cq_mask];
+            __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+            buffer& b = bufs[cqe.user_data];
+            reaped++;
+            if(cqe.res == sys::err_intr || cqe.res == sys::err_again) {
+                submit((u32)cqe.user_data);
+                continue;
+            }
+            if(cqe.res <= 0) {
+                if(!err) err = cqe.res < 0 ? cqe.res : -5;
+                finish((u32)cqe.user_data);
+                continue;
+            }
+            b.done += (u32)cqe.res;
+            if(b.done < b.len) submit((u32)cqe.user_data);
+            else finish((u32)cqe.user_data);
+        }
+        return reaped;
+    }
+
+    // Fallback: writes buffers 0..last in order with as few writev calls as
+    // partial writes allow.
+    void gather(u32 last) {
+        sys::iovec iov[RAZ_ASYNC_MAX_BUFFERS];
+        u32 first = 0;
+        while(first <= last) {
+            i32 n = 0;
+            for(u32 i = first; i <= last; i++) {
+                if(bufs[i].len == bufs[i].done) continue;
+                iov[n].base = bufs[i].data + bufs[i].done;
+                iov[n].len = bufs[i].len - bufs[i].done;
+                n++;
+            }
+            if(n == 0) break;
+            long ret = sys::writev(fd, iov, n);
+            RAZ_STAT(stats.ostreams.record_io(ret));
+            if(ret <= 0) {
+                if(!err) err = ret < 0 ? (i32)ret : -5;
+                break;
+            }
+            u64 left = (u64)ret;
+            while(first <= last && left) {
+                u32 rest = bufs[first].len - bufs[first].done;
+                u32 step = left < rest ? (u32)left : rest;
+                bufs[first].done += step;
+                left -= step;
+                if(bufs[first].done == bufs[first].len) first++;
+            }
+        }
+        for(u32 i = 0; i <= last; i++) release(bufs[i]);
+    }
+
+    // Hands off the buffer being filled and moves to a free one, waiting for
+    // a completion only when every buffer is still in flight.
+    void rotate() {
+        buffer& cur = bufs[current];
+        if(cur.len == 0) return;
+        if(ring_fd < 0) {
+            if(current + 1 < count) {
+                current++;
+            } else {
+                gather(current);
+                current = 0;
+            }
+            return;
+        }
+        if(!seekable) {
+            enqueue(current);
+        } else {
+            if(synced) {
+                next_offset = (u64)sys::lseek(fd, 0, sys::seek_cur);
+                synced = false;
+            }
+            cur.offset = next_offset;
+            next_offset += cur.len;
+            submit(current);
+        }
+        reap(false);
+        while(true) {
+            for(u32 k = 1; k <= count; k++) {
+                u32 i = (current + k) % count;
+                if(!bufs[i].in_flight) {
+                    current = i;
+                    return;
+                }
+            }
+            reap(true);
+        }
+    }
+
+    void write_bytes(const char* str, u32 len) {
+        while(len > 0) {
+            buffer& cur = bufs[current];
+            u32 room = size - cur.len;
+            u32 n = len < room ? len : room;
+            memcpy_simple(cur.data + cur.len, str, n);
+            cur.len += n;
+            str += n;
+            len -= n;
+            if(cur.len == size) rotate();
+        }
+    }
+
+public:
+    // `buffers` (2..RAZ_ASYNC_MAX_BUFFERS) of `buffer_size` bytes are mapped once
+    // here. `use_ring = false` forces the writev path.
+    explicit async_writer(i32 out_fd, u32 buffers = 2, u32 buffer_size = RAZ_ASYNC_BUFFER_SIZE, bool use_ring = true)
+        : count(buffers), size(buffer_size), current(0), in_flight(0), fd(out_fd), err(0),
+          seekable(false), synced(false), next_offset(0), queue_head(0), queue_len(0), ring_fd(-1) {
+        if(count < 2) count = 2;
+        if(count > RAZ_ASYNC_MAX_BUFFERS) count = RAZ_ASYNC_MAX_BUFFERS;
+        if(size < 4096) size = 4096;
+        memory = (char*)sys::mmap(nullptr, (u64)count * size, sys::prot_read | sys::prot_write,
+                                  sys::map_private | sys::map_anonymous);
+        // Nothing to buffer into; fail here rather than on the first write.
+        if(!memory) __builtin_trap();
+        for(u32 i = 0; i < count; i++) {
+            bufs[i] = buffer();
+            bufs[i].data = memory + (u64)i * size;
+        }
+        long pos = sys::lseek(fd, 0, sys::seek_cur);
+        long fl = sys::fcntl(fd, sys::f_getfl);
+        if(pos >= 0 && fl >= 0 && !(fl & sys::o_append)) {
+            seekable = true;
+            next_offset = (u64)pos;
+        }
+        if(use_ring) setup_ring();
+    }
+
+    async_writer(const async_writer&) = delete;
+    async_writer& operator=(const async_writer&) = delete;
+
+    ~async_writer() {
+        sync();
+        close_ring();
+        sys::munmap(memory, (u64)count * size);
+    }
+
+    bool uses_ring() const { return ring_fd >= 0; }
+
+    // First failure as a negative errno, 0 if every write so far succeeded.
+    i32 error() const { return err; }
+
+    // Buffers handed to the kernel and not yet completed.
+    u32 pending() const { return in_flight; }
+
+    // Submits what has been written so far without waiting for it.
+    void flush() {
+        if(ring_fd < 0) {
+            // Buffers before `current` are full and still unwritten.
+            if(current > 0 || bufs[current].len) gather(current);
+            current = 0;
+            return;
+        }
+        rotate();
+    }
+
+    // Reaps finished writes without blocking; returns how many were reaped.
+    u32 poll() {
+        return ring_fd < 0 ? 0 : reap(false);
+    }
+
+    // Flushes and blocks until everything is written. The descriptor's file
+    // position is then moved past the data, so direct writes may follow; the
+    // next buffer starts wherever they leave it.
+    void sync() {
+        flush();
+        if(ring_fd < 0) return;
+        while(in_flight > 0) reap(true);
+        if(seekable) {
+            sys::lseek(fd, (long)next_offset, sys::seek_set);
+            synced = true;
+        }
+    }
+
+    template<typename F>
+    void emit(u32 max_len, F format) {
+        if(max_len > size) {
+            heap_allocator heap;
+            char* tmp = (char*)heap.allocate(max_len);
+            write_bytes(tmp, format(tmp));
+            heap.deallocate(tmp, max_len);
+            return;
+        }
+        if(bufs[current].len + max_len > size) rotate();
+        buffer& cur = bufs[current];
+        cur.len += format(cur.data + cur.len);
+        if(cur.len == size) rotate();
+    }
+
+    void write(const char* str, u32 len) { write_bytes(str, len); }
+
+    template<typename... Args>
+    void print(format_string_for<Args...> fmt, const Args&... args) {
+        detail::format_arg packed[sizeof...(Args) + 1] = {detail::make_format_arg(args)...};
+        u32 bound = detail::format_bound(fmt.str, fmt.literal_total, fmt.specs, fmt.count, packed);
+        emit(bound, [&](char* out) {
+            format_sink sink(out, bound);
+            detail::format_run(sink, fmt.str, fmt.specs, fmt.count, packed);
+            return sink.size();
+        });
+    }
+
+    async_writer& operator<<(const char* str) { write_bytes(str, strlen_simple(str)); return *this; }
+    template<typename A>
+    async_writer& operator<<(const basic_string<A>& str) { write_bytes(str.c_str(), str.length()); return *this; }
+    async_writer& operator<<(string_view str) { write_bytes(str.data(), str.length()); return *this; }
+    async_writer& operator<<(char c) { write_bytes(&c, 1); return *this; }
+    async_writer& operator<<(bool b) { return *this << (b ? "true" : "false"); }
+    async_writer& operator<<(const endl_t&) { return *this << '\n'; }
+    async_writer& operator<<(i32 num) { emit(format_int_max, [num](char* out) { return format_i32(out, num); }); return *this; }
+    async_writer& operator<<(u32 num) { emit(format_int_max, [num](char* out) { return format_u32(out, num); }); return *this; }
+    async_writer& operator<<(i64 num) { emit(format_int_max, [num](char* out) { return format_i64(out, num); }); return *this; }
+    async_writer& operator<<(u64 num) { emit(format_int_max, [num](char* out) { return format_u64(out, num); }); return *this; }
+    async_writer& operator<<(long num) { return *this << (i64)num; }
+    async_writer& operator<<(unsigned long num) { return *this << (u64)num; }
+    async_writer& operator<<(f64 num) { emit(format_float_max, [num](char* out) { return format_f64(out, num); }); return *this; }
+    async_writer& operator<<(f32 num) { emit(format_float_max, [num](char* out) { return format_f32(out, num); }); return *this; }
+
+    async_writer& operator<<(radix_value v) {
+        emit(format_int_max * 3, [v](char* out) { return format_radix(out, v.value, v.base, v.upper); });
+        return *this;
+    }
+
+    async_writer& operator<<(fixed_value v) {
+        emit(format_fixed_max, [v](char* out) { return format_fixed(out, v.value, v.precision); });
+        return *this;
+    }
+};
+
+#ifdef RAZ_INSTRUMENT
+namespace detail {
+
+inline void dump_container(ostream& out, const char* name, const container_stats& c) {
+    char line[160];
+    f64 avg = c.lookups ? (f64)c.scanned / (f64)c.lookups : 0.0;
+    u32 n = format_to(line, sizeof(line), "{:<10}{:>10}{:>14}{:>9}{:>9}{:>11}{:>11}{:>10.2f}{:>10}\n",
+                      name, c.allocations, c.bytes, c.growths, c.copies, c.peak_capacity, c.lookups, avg, c.max_scan);
+    out << string_view(line, n);
+}
+
+inline void dump_stream(ostream& out, const char* name, const stream_stats& io) {
+    char line[80];
+    u32 n = format_to(line, sizeof(line), "{:<10}{:>10}{:>14}\n", name, io.syscalls, io.bytes);
+    out << string_view(line, n);
+}
+
+}
+
+// Prints every counter as a table. The snapshot is taken first so the dump's
+// own output does not show up in the stream rows.
+void dump_stats(ostream& out = cout) {
+    instrument_stats snap = stats;
+    char line[160];
+    u32 n = format_to(line, sizeof(line), "{:<10}{:>10}{:>14}{:>9}{:>9}{:>11}{:>11}{:>10}{:>10}\n",
+                      "container", "allocs", "bytes", "grows", "copies", "peak_cap", "lookups", "avg_scan", "max_scan");
+    out << string_view(line, n);
+    detail::dump_container(out, "string", snap.strings);
+    detail::dump_container(out, "vector", snap.vectors);
+    detail::dump_container(out, "map", snap.maps);
+    detail::dump_container(out, "hash_map", snap.hash_maps);
+    detail::dump_container(out, "deque", snap.deques);
+    n = format_to(line, sizeof(line), "{:<10}{:>10}{:>14}\n", "stream", "syscalls", "bytes");
+    out << string_view(line, n);
+    detail::dump_stream(out, "ostream", snap.ostreams);
+    detail::dump_stream(out, "istream", snap.istreams);
+    out.flush();
+}
+
+void reset_stats() { stats = instrument_stats(); }
+#else
+void dump_stats(ostream& = cout) {}
+void reset_stats() {}
+#endif
+
+enum class parse_error : u8 {
+    none,
+    invalid,
+    out_of_range
+};
+
+template<typename T>
+struct parse_result {
+    T value;
+    const char* end;
+    parse_error error;
+
+    explicit operator bool() const { return error == parse_error::none; }
+};
+
+namespace detail {
+
+inline u64 mul_128(u64 a, u64 b, u64& hi) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    hi = (u64)(r >> 64);
+    return (u64)r;
+#else
+    u64 a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+    u64 b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+    u64 p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+    u64 mid = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+    hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+    return (mid << 32) | (p0 & 0xFFFFFFFFu);
+#endif
+}
+
+inline bool is_digit(char c) { return (u8)(c - '0') < 10; }
+
+inline u64 load_u64_le(const char* p) {
+    u64 v;
+    memcpy_simple(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// True when all eight bytes are ASCII digits.
+inline bool is_eight_digits(u64 v) {
+    return (((v + 0x4646464646464646ULL) | (v - 0x3030303030303030ULL)) & 0x8080808080808080ULL) == 0;
+}
+
+// Eight ASCII digits (first digit in the lowest byte) to their value.
+inline u32 parse_eight_digits(u64 v) {
+    const u64 mask = 0x000000FF000000FFULL;
+    const u64 mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+    const u64 mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return (u32)v;
+}
+
+// Accumulates digits into `value`; returns false on u64 overflow (the
+// remaining digits are still consumed).
+inline bool parse_digits(const char*& p, const char* last, u64& value) {
+    bool ok = true;
+    while(last - p >= 8) {
+        u64 chunk = load_u64_le(p);
+        if(!is_eight_digits(chunk)) break;
+        u64 scaled;
+        if(__builtin_mul_overflow(value, (u64)100000000, &scaled)
+           || __builtin_add_overflow(scaled, (u64)parse_eight_digits(chunk), &value)) ok = false;
+        p += 8;
+    }
+    while(p < last && is_digit(*p)) {
+        u64 scaled;
+        if(__builtin_mul_overflow(value, (u64)10, &scaled)
+           || __builtin_add_overflow(scaled, (u64)(*p - '0'), &value)) ok = false;
+        p++;
+    }
+    return ok;
+}
+
+template<typename T>
+parse_result<T> parse_unsigned(const char* first, const char* last, u64 max) {
+    const char* p = first;
+    if(p < last && *p == '+') p++;
+    const char* digits = p;
+    u64 value = 0;
+    bool ok = parse_digits(p, last, value);
+    if(p == digits) return parse_result<T>{0, first, parse_error::invalid};
+    if(!ok || value > max) return parse_result<T>{(T)max, p, parse_error::out_of_range};
+    return parse_result<T>{(T)value, p, parse_error::none};
+}
+
+template<typename T>
+parse_result<T> parse_signed(const char* first, const char* last, u64 max) {
+    const char* p = first;
+    bool negative = false;
+    if(p < last && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    const char* digits = p;
+    u64 value = 0;
+    bool ok = parse_digits(p, last, value);
+    if(p == digits) return parse_result<T>{0, first, parse_error::invalid};
+    u64 limit = max + negative;
+    if(!ok || value > limit) {
+        T clamped = negative ? (T)(0 - limit) : (T)max;
+        return parse_result<T>{clamped, p, parse_error::out_of_range};
+    }
+    T result = negative ? (T)(0 - value) : (T)value;
+    return parse_result<T>{result, p, parse_error::none};
+}
+
+// Normalized 128-bit mantissas of 10^q for q = -342..308, rounded down.
+static constexpr i32 pow10_min = -342;
+static constexpr i32 pow10_max = 308;
+static constexpr u64 pow10_128[][2] = {
+    { 0xEEF453D6923BD65AULL, 0x113FAA2906A13B3FULL },
+    { 0x9558B4661B6565F8ULL, 0x4AC7CA59A424C507ULL },
+    { 0xBAAEE17FA23EBF76ULL, 0x5D79BCF00D2DF649ULL },
+    { 0xE95A99DF8ACE6F53ULL, 0xF4D82C2C107973DCULL },
+    { 0x91D8A02BB6C10594ULL, 0x79071B9B8A4BE869ULL },
+    { 0xB64EC836A47146F9ULL, 0x9748E2826CDEE284ULL },
+    { 0xE3E27A444D8D98B7ULL, 0xFD1B1B2308169B25ULL },
+    { 0x8E6D8C6AB0787F72ULL, 0xFE30F0F5E50E20F7ULL },
+    { 0xB208EF855C969F4FULL, 0xBDBD2D335E51A935ULL },
+    { 0xDE8B2B66B3BC4723ULL, 0xAD2C788035E61382ULL },
+    { 0x8B16FB203055AC76ULL, 0x4C3BCB5021AFCC31ULL },
+    { 0xADDCB9E83C6B1793ULL, 0xDF4ABE242A1BBF3DULL },
+    { 0xD953E8624B85DD78ULL, 0xD71D6DAD34A2AF0DULL },
+    { 0x87D4713D6F33AA6BULL, 0x8672648C40E5AD68ULL },
+    { 0xA9C98D8CCB009506ULL, 0x680EFDAF511F18C2ULL },
+    { 0xD43BF0EFFDC0BA48ULL, 0x0212BD1B2566DEF2ULL },
+    { 0x84A57695FE98746DULL, 0x014BB630F7604B57ULL },
+    { 0xA5CED43B7E3E9188ULL, 0x419EA3BD35385E2DULL },
+    { 0xCF42894A5DCE35EAULL, 0x52064CAC828675B9ULL },
+    { 0x818995CE7AA0E1B2ULL, 0x7343EFEBD1940993ULL },
+    { 0xA1EBFB4219491A1FULL, 0x1014EBE6C5F90BF8ULL },
+    { 0xCA66FA129F9B60A6ULL, 0xD41A26E077774EF6ULL },
+    { 0xFD00B897478238D0ULL, 0x8920B098955522B4ULL },
+    { 0x9E20735E8CB16382ULL, 0x55B46E5F5D5535B0ULL },
+    { 0xC5A890362FDDBC62ULL, 0xEB2189F734AA831DULL },
+    { 0xF712B443BBD52B7BULL, 0xA5E9EC7501D523E4ULL },
+    { 0x9A6BB0AA55653B2DULL, 0x47B233C92125366EULL },
+    { 0xC1069CD4EABE89F8ULL, 0x999EC0BB696E840AULL },
+    { 0xF148440A256E2C76ULL, 0xC00670EA43CA250DULL },
+    { 0x96CD2A865764DBCAULL, 0x380406926A5E5728ULL },
+    { 0xBC807527ED3E12BCULL, 0xC605083704F5ECF2ULL },
+    { 0xEBA09271E88D976BULL, 0xF7864A44C633682EULL },
+    { 0x93445B8731587EA3ULL, 0x7AB3EE6AFBE0211DULL },
+    { 0xB8157268FDAE9E4CULL, 0x5960EA05BAD82964ULL },
+    { 0xE61ACF033D1A45DFULL, 0x6FB92487298E33BDULL },
+    { 0x8FD0C16206306BABULL, 0xA5D3B6D479F8E056ULL },
+    { 0xB3C4F1BA87BC8696ULL, 0x8F48A4899877186CULL },
+    { 0xE0B62E2929ABA83CULL, 0x331ACDABFE94DE87ULL },
+    { 0x8C71DCD9BA0B4925ULL, 0x9FF0C08B7F1D0B14ULL },
+    { 0xAF8E5410288E1B6FULL, 0x07ECF0AE5EE44DD9ULL },
+    { 0xDB71E91432B1A24AULL, 0xC9E82CD9F69D6150ULL },
+    { 0x892731AC9FAF056EULL, 0xBE311C083A225CD2ULL },
+    { 0xAB70FE17C79AC6CAULL, 0x6DBD630A48AAF406ULL },
+    { 0xD64D3D9DB981787DULL, 0x092CBBCCDAD5B108ULL },
+    { 0x85F0468293F0EB4EULL, 0x25BBF56008C58EA5ULL },
+    { 0xA76C582338ED2621ULL, 0xAF2AF2B80AF6F24EULL },
+    { 0xD1476E2C07286FAAULL, 0x1AF5AF660DB4AEE1ULL },
+    { 0x82CCA4DB847945CAULL, 0x50D98D9FC890ED4DULL },
+    { 0xA37FCE126597973CULL, 0xE50FF107BAB528A0ULL },
+    { 0xCC5FC196FEFD7D0CULL, 0x1E53ED49A96272C8ULL },
+    { 0xFF77B1FCBEBCDC4FULL, 0x25E8E89C13BB0F7AULL },
+    { 0x9FAACF3DF73609B1ULL, 0x77B191618C54E9ACULL },
+    { 0xC795830D75038C1DULL, 0xD59DF5B9EF6A2417ULL },
+    { 0xF97AE3D0D2446F25ULL, 0x4B0573286B44AD1DULL },
+    { 0x9BECCE62836AC577ULL, 0x4EE367F9430AEC32ULL },
+    { 0xC2E801FB244576D5ULL, 0x229C41F793CDA73FULL },
+    { 0xF3A20279ED56D48AULL, 0x6B43527578C1110FULL },
+    { 0x9845418C345644D6ULL, 0x830A13896B78AAA9ULL },
+    { 0xBE5691EF416BD60CULL, 0x23CC986BC656D553ULL },
+    { 0xEDEC366B11C6CB8FULL, 0x2CBFBE86B7EC8AA8ULL },
+    { 0x94B3A202EB1C3F39ULL, 0x7BF7D71432F3D6A9ULL },
+    { 0xB9E08A83A5E34F07ULL, 0xDAF5CCD93FB0CC53ULL },
+    { 0xE858AD248F5C22C9ULL, 0xD1B3400F8F9CFF68ULL },
+    { 0x91376C36D99995BEULL, 0x23100809B9C21FA1ULL },
+    { 0xB58547448FFFFB2DULL, 0xABD40A0C2832A78AULL },
+    { 0xE2E69915B3FFF9F9ULL, 0x16C90C8F323F516CULL },
+    { 0x8DD01FAD907FFC3BULL, 0xAE3DA7D97F6792E3ULL },
+    { 0xB1442798F49FFB4AULL, 0x99CD11CFDF41779CULL },
+    { 0xDD95317F31C7FA1DULL, 0x40405643D711D583ULL },
+    { 0x8A7D3EEF7F1CFC52ULL, 0x482835EA666B2572ULL },
+    { 0xAD1C8EAB5EE43B66ULL, 0xDA3243650005EECFULL },
+    { 0xD863B256369D4A40ULL, 0x90BED43E40076A82ULL },
+    { 0x873E4F75E2224E68ULL, 0x5A7744A6E804A291ULL },
+    { 0xA90DE3535AAAE202ULL, 0x711515D0A205CB36ULL },
+    { 0xD3515C2831559A83ULL, 0x0D5A5B44CA873E03ULL },
+    { 0x8412D9991ED58091ULL, 0xE858790AFE9486C2ULL },
+    { 0xA5178FFF668AE0B6ULL, 0x626E974DBE39A872ULL },
+    { 0xCE5D73FF402D98E3ULL, 0xFB0A3D212DC8128FULL },
+    { 0x80FA687F881C7F8EULL, 0x7CE66634BC9D0B99ULL },
+    { 0xA139029F6A239F72ULL, 0x1C1FFFC1EBC44E80ULL },
+    { 0xC987434744AC874EULL, 0xA327FFB266B56220ULL },
+    { 0xFBE9141915D7A922ULL, 0x4BF1FF9F0062BAA8ULL },
+    { 0x9D71AC8FADA6C9B5ULL, 0x6F773FC3603DB4A9ULL },
+    { 0xC4CE17B399107C22ULL, 0xCB550FB4384D21D3ULL },
+    { 0xF6019DA07F549B2BULL, 0x7E2A53A146606A48ULL },
+    { 0x99C102844F94E0FBULL, 0x2EDA7444CBFC426DULL },
+    { 0xC0314325637A1939ULL, 0xFA911155FEFB5308ULL },
+    { 0xF03D93EEBC589F88ULL, 0x793555AB7EBA27CAULL },
+    { 0x96267C7535B763B5ULL, 0x4BC1558B2F3458DEULL },
+    { 0xBBB01B9283253CA2ULL, 0x9EB1AAEDFB016F16ULL },
+    { 0xEA9C227723EE8BCBULL, 0x465E15A979C1CADCULL },
+    { 0x92A1958A7675175FULL, 0x0BFACD89EC191EC9ULL },
+    { 0xB749FAED14125D36ULL, 0xCEF980EC671F667BULL },
+    { 0xE51C79A85916F484ULL, 0x82B7E12780E7401AULL },
+    { 0x8F31CC0937AE58D2ULL, 0xD1B2ECB8B0908810ULL },
+    { 0xB2FE3F0B8599EF07ULL, 0x861FA7E6DCB4AA15ULL },
+    { 0xDFBDCECE67006AC9ULL, 0x67A791E093E1D49AULL },
+    { 0x8BD6A141006042BDULL, 0xE0C8BB2C5C6D24E0ULL },
+    { 0xAECC49914078536DULL, 0x58FAE9F773886E18ULL },
+    { 0xDA7F5BF590966848ULL, 0xAF39A475506A899EULL },
+    { 0x888F99797A5E012DULL, 0x6D8406C952429603ULL },
+    { 0xAAB37FD7D8F58178ULL, 0xC8E5087BA6D33B83ULL },
+    { 0xD5605FCDCF32E1D6ULL, 0xFB1E4A9A90880A64ULL },
+    { 0x855C3BE0A17FCD26ULL, 0x5CF2EEA09A55067FULL },
+    { 0xA6B34AD8C9DFC06FULL, 0xF42FAA48C0EA481EULL },
+    { 0xD0601D8EFC57B08BULL, 0xF13B94DAF124DA26ULL },
+    { 0x823C12795DB6CE57ULL, 0x76C53D08D6B70858ULL },
+    { 0xA2CB1717B52481EDULL, 0x54768C4B0C64CA6EULL },
+    { 0xCB7DDCDDA26DA268ULL, 0xA9942F5DCF7DFD09ULL },
+    { 0xFE5D54150B090B02ULL, 0xD3F93B35435D7C4CULL },
+    { 0x9EFA548D26E5A6E1ULL, 0xC47BC5014A1A6DAFULL },
+    { 0xC6B8E9B0709F109AULL, 0x359AB6419CA1091BULL },
+    { 0xF867241C8CC6D4C0ULL, 0xC30163D203C94B62ULL },
+    { 0x9B407691D7FC44F8ULL, 0x79E0DE63425DCF1DULL },
+    { 0xC21094364DFB5636ULL, 0x985915FC12F542E4ULL },
+    { 0xF294B943E17A2BC4ULL, 0x3E6F5B7B17B2939DULL },
+    { 0x979CF3CA6CEC5B5AULL, 0xA705992CEECF9C42ULL },
+    { 0xBD8430BD08277231ULL, 0x50C6FF782A838353ULL },
+    { 0xECE53CEC4A314EBDULL, 0xA4F8BF5635246428ULL },
+    { 0x940F4613AE5ED136ULL, 0x871B7795E136BE99ULL },
+    { 0xB913179899F68584ULL, 0x28E2557B59846E3FULL },
+    { 0xE757DD7EC07426E5ULL, 0x331AEADA2FE589CFULL },
+    { 0x9096EA6F3848984FULL, 0x3FF0D2C85DEF7621ULL },
+    { 0xB4BCA50B065ABE63ULL, 0x0FED077A756B53A9ULL },
+    { 0xE1EBCE4DC7F16DFBULL, 0xD3E8495912C62894ULL },
+    { 0x8D3360F09CF6E4BDULL, 0x64712DD7ABBBD95CULL },
+    { 0xB080392CC4349DECULL, 0xBD8D794D96AACFB3ULL },
+    { 0xDCA04777F541C567ULL, 0xECF0D7A0FC5583A0ULL },
+    { 0x89E42CAAF9491B60ULL, 0xF41686C49DB57244ULL },
+    { 0xAC5D37D5B79B6239ULL, 0x311C2875C522CED5ULL },
+    { 0xD77485CB25823AC7ULL, 0x7D633293366B828BULL },
+    { 0x86A8D39EF77164BCULL, 0xAE5DFF9C02033197ULL },
+    { 0xA8530886B54DBDEBULL, 0xD9F57F830283FDFCULL },
+    { 0xD267CAA862A12D66ULL, 0xD072DF63C324FD7BULL },
+    { 0x8380DEA93DA4BC60ULL, 0x4247CB9E59F71E6DULL },
+    { 0xA46116538D0DEB78ULL, 0x52D9BE85F074E608ULL },
+    { 0xCD795BE870516656ULL, 0x67902E276C921F8BULL },
+    { 0x806BD9714632DFF6ULL, 0x00BA1CD8A3DB53B6ULL },
+    { 0xA086CFCD97BF97F3ULL, 0x80E8A40ECCD228A4ULL },
+    { 0xC8A883C0FDAF7DF0ULL, 0x6122CD128006B2CDULL },
+    { 0xFAD2A4B13D1B5D6CULL, 0x796B805720085F81ULL },
+    { 0x9CC3A6EEC6311A63ULL, 0xCBE3303674053BB0ULL },
+    { 0xC3F490AA77BD60FCULL, 0xBEDBFC4411068A9CULL },
+    { 0xF4F1B4D515ACB93BULL, 0xEE92FB5515482D44ULL },
+    { 0x991711052D8BF3C5ULL, 0x751BDD152D4D1C4AULL },
+    { 0xBF5CD54678EEF0B6ULL, 0xD262D45A78A0635DULL },
+    { 0xEF340A98172AACE4ULL, 0x86FB897116C87C34ULL },
+    { 0x9580869F0E7AAC0EULL, 0xD45D35E6AE3D4DA0ULL },
+    { 0xBAE0A846D2195712ULL, 0x8974836059CCA109ULL },
+    { 0xE998D258869FACD7ULL, 0x2BD1A438703FC94BULL },
+    { 0x91FF83775423CC06ULL, 0x7B6306A34627DDCFULL },
+    { 0xB67F6455292CBF08ULL, 0x1A3BC84C17B1D542ULL },
+    { 0xE41F3D6A7377EECAULL, 0x20CABA5F1D9E4A93ULL },
+    { 0x8E938662882AF53EULL, 0x547EB47B7282EE9CULL },
+    { 0xB23867FB2A35B28DULL, 0xE99E619A4F23AA43ULL },
+    { 0xDEC681F9F4C31F31ULL, 0x6405FA00E2EC94D4ULL },
+    { 0x8B3C113C38F9F37EULL, 0xDE83BC408DD3DD04ULL },
+    { 0xAE0B158B4738705EULL, 0x9624AB50B148D445ULL },
+    { 0xD98DDAEE19068C76ULL, 0x3BADD624DD9B0957ULL },
+    { 0x87F8A8D4CFA417C9ULL, 0xE54CA5D70A80E5D6ULL },
+    { 0xA9F6D30A038D1DBCULL, 0x5E9FCF4CCD211F4CULL },
+    { 0xD47487CC8470652BULL, 0x7647C3200069671FULL },
+    { 0x84C8D4DFD2C63F3BULL, 0x29ECD9F40041E073ULL },
+    { 0xA5FB0A17C777CF09ULL, 0xF468107100525890ULL },
+    { 0xCF79CC9DB955C2CCULL, 0x7182148D4066EEB4ULL },
+    { 0x81AC1FE293D599BFULL, 0xC6F14CD848405530ULL },
+    { 0xA21727DB38CB002FULL, 0xB8ADA00E5A506A7CULL },
+    { 0xCA9CF1D206FDC03BULL, 0xA6D90811F0E4851CULL },
+    { 0xFD442E4688BD304AULL, 0x908F4A166D1DA663ULL },
+    { 0x9E4A9CEC15763E2EULL, 0x9A598E4E043287FEULL },
+    { 0xC5DD44271AD3CDBAULL, 0x40EFF1E1853F29FDULL },
+    { 0xF7549530E188C128ULL, 0xD12BEE59E68EF47CULL },
+    { 0x9A94DD3E8CF578B9ULL, 0x82BB74F8301958CEULL },
+    { 0xC13A148E3032D6E7ULL, 0xE36A52363C1FAF01ULL },
+    { 0xF18899B1BC3F8CA1ULL, 0xDC44E6C3CB279AC1ULL },
+    { 0x96F5600F15A7B7E5ULL, 0x29AB103A5EF8C0B9ULL },
+    { 0xBCB2B812DB11A5DEULL, 0x7415D448F6B6F0E7ULL },
+    { 0xEBDF661791D60F56ULL, 0x111B495B3464AD21ULL },
+    { 0x936B9FCEBB25C995ULL, 0xCAB10DD900BEEC34ULL },
+    { 0xB84687C269EF3BFBULL, 0x3D5D514F40EEA742ULL },
+    { 0xE65829B3046B0AFAULL, 0x0CB4A5A3112A5112ULL },
+    { 0x8FF71A0FE2C2E6DCULL, 0x47F0E785EABA72ABULL },
+    { 0xB3F4E093DB73A093ULL, 0x59ED216765690F56ULL },
+    { 0xE0F218B8D25088B8ULL, 0x306869C13EC3532CULL },
+    { 0x8C974F7383725573ULL, 0x1E414218C73A13FBULL },
+    { 0xAFBD2350644EEACFULL, 0xE5D1929EF90898FAULL },
+    { 0xDBAC6C247D62A583ULL, 0xDF45F746B74ABF39ULL },
+    { 0x894BC396CE5DA772ULL, 0x6B8BBA8C328EB783ULL },
+    { 0xAB9EB47C81F5114FULL, 0x066EA92F3F326564ULL },
+    { 0xD686619BA27255A2ULL, 0xC80A537B0EFEFEBDULL },
+    { 0x8613FD0145877585ULL, 0xBD06742CE95F5F36ULL },
+    { 0xA798FC4196E952E7ULL, 0x2C48113823B73704ULL },
+    { 0xD17F3B51FCA3A7A0ULL, 0xF75A15862CA504C5ULL },
+    { 0x82EF85133DE648C4ULL, 0x9A984D73DBE722FBULL },
+    { 0xA3AB66580D5FDAF5ULL, 0xC13E60D0D2E0EBBAULL },
+    { 0xCC963FEE10B7D1B3ULL, 0x318DF905079926A8ULL },
+    { 0xFFBBCFE994E5C61FULL, 0xFDF17746497F7052ULL },
+    { 0x9FD561F1FD0F9BD3ULL, 0xFEB6EA8BEDEFA633ULL },
+    { 0xC7CABA6E7C5382C8ULL, 0xFE64A52EE96B8FC0ULL },
+    { 0xF9BD690A1B68637BULL, 0x3DFDCE7AA3C673B0ULL },
+    { 0x9C1661A651213E2DULL, 0x06BEA10CA65C084EULL },
+    { 0xC31BFA0FE5698DB8ULL, 0x486E494FCFF30A62ULL },
+    { 0xF3E2F893DEC3F126ULL, 0x5A89DBA3C3EFCCFAULL },
+    { 0x986DDB5C6B3A76B7ULL, 0xF89629465A75E01CULL },
+    { 0xBE89523386091465ULL, 0xF6BBB397F1135823ULL },
+    { 0xEE2BA6C0678B597FULL, 0x746AA07DED582E2CULL },
+    { 0x94DB483840B717EFULL, 0xA8C2A44EB4571CDCULL },
+    { 0xBA121A4650E4DDEBULL, 0x92F34D62616CE413ULL },
+    { 0xE896A0D7E51E1566ULL, 0x77B020BAF9C81D17ULL },
+    { 0x915E2486EF32CD60ULL, 0x0ACE1474DC1D122EULL },
+    { 0xB5B5ADA8AAFF80B8ULL, 0x0D819992132456BAULL },
+    { 0xE3231912D5BF60E6ULL, 0x10E1FFF697ED6C69ULL },
+    { 0x8DF5EFABC5979C8FULL, 0xCA8D3FFA1EF463C1ULL },
+    { 0xB1736B96B6FD83B3ULL, 0xBD308FF8A6B17CB2ULL },
+    { 0xDDD0467C64BCE4A0ULL, 0xAC7CB3F6D05DDBDEULL },
+    { 0x8AA22C0DBEF60EE4ULL, 0x6BCDF07A423AA96BULL },
+    { 0xAD4AB7112EB3929DULL, 0x86C16C98D2C953C6ULL },
+    { 0xD89D64D57A607744ULL, 0xE871C7BF077BA8B7ULL },
+    { 0x87625F056C7C4A8BULL, 0x11471CD764AD4972ULL },
+    { 0xA93AF6C6C79B5D2DULL, 0xD598E40D3DD89BCFULL },
+    { 0xD389B47879823479ULL, 0x4AFF1D108D4EC2C3ULL },
+    { 0x843610CB4BF160CBULL, 0xCEDF722A585139BAULL },
+    { 0xA54394FE1EEDB8FEULL, 0xC2974EB4EE658828ULL },
+    { 0xCE947A3DA6A9273EULL, 0x733D226229FEEA32ULL },
+    { 0x811CCC668829B887ULL, 0x0806357D5A3F525FULL },
+    { 0xA163FF802A3426A8ULL, 0xCA07C2DCB0CF26F7ULL },
+    { 0xC9BCFF6034C13052ULL, 0xFC89B393DD02F0B5ULL },
+    { 0xFC2C3F3841F17C67ULL, 0xBBAC2078D443ACE2ULL },
+    { 0x9D9BA7832936EDC0ULL, 0xD54B944B84AA4C0DULL },
+    { 0xC5029163F384A931ULL, 0x0A9E795E65D4DF11ULL },
+    { 0xF64335BCF065D37DULL, 0x4D4617B5FF4A16D5ULL },
+    { 0x99EA0196163FA42EULL, 0x504BCED1BF8E4E45ULL },
+    { 0xC06481FB9BCF8D39ULL, 0xE45EC2862F71E1D6ULL },
+    { 0xF07DA27A82C37088ULL, 0x5D767327BB4E5A4CULL },
+    { 0x964E858C91BA2655ULL, 0x3A6A07F8D510F86FULL },
+    { 0xBBE226EFB628AFEAULL, 0x890489F70A55368BULL },
+    { 0xEADAB0ABA3B2DBE5ULL, 0x2B45AC74CCEA842EULL },
+    { 0x92C8AE6B464FC96FULL, 0x3B0B8BC90012929DULL },
+    { 0xB77ADA0617E3BBCBULL, 0x09CE6EBB40173744ULL },
+    { 0xE55990879DDCAABDULL, 0xCC420A6A101D0515ULL },
+    { 0x8F57FA54C2A9EAB6ULL, 0x9FA946824A12232DULL },
+    { 0xB32DF8E9F3546564ULL, 0x47939822DC96ABF9ULL },
+    { 0xDFF9772470297EBDULL, 0x59787E2B93BC56F7ULL },
+    { 0x8BFBEA76C619EF36ULL, 0x57EB4EDB3C55B65AULL },
+    { 0xAEFAE51477A06B03ULL, 0xEDE622920B6B23F1ULL },
+    { 0xDAB99E59958885C4ULL, 0xE95FAB368E45ECEDULL },
+    { 0x88B402F7FD75539BULL, 0x11DBCB0218EBB414ULL },
+    { 0xAAE103B5FCD2A881ULL, 0xD652BDC29F26A119ULL },
+    { 0xD59944A37C0752A2ULL, 0x4BE76D3346F0495FULL },
+    { 0x857FCAE62D8493A5ULL, 0x6F70A4400C562DDBULL },
+    { 0xA6DFBD9FB8E5B88EULL, 0xCB4CCD500F6BB952ULL },
+    { 0xD097AD07A71F26B2ULL, 0x7E2000A41346A7A7ULL },
+    { 0x825ECC24C873782FULL, 0x8ED400668C0C28C8ULL },
+    { 0xA2F67F2DFA90563BULL, 0x728900802F0F32FAULL },
+    { 0xCBB41EF979346BCAULL, 0x4F2B40A03AD2FFB9ULL },
+    { 0xFEA126B7D78186BCULL, 0xE2F610C84987BFA8ULL },
+    { 0x9F24B832E6B0F436ULL, 0x0DD9CA7D2DF4D7C9ULL },
+    { 0xC6EDE63FA05D3143ULL, 0x91503D1C79720DBBULL },
+    { 0xF8A95FCF88747D94ULL, 0x75A44C6397CE912AULL },
+    { 0x9B69DBE1B548CE7CULL, 0xC986AFBE3EE11ABAULL },
+    { 0xC24452DA229B021BULL, 0xFBE85BADCE996168ULL },
+    { 0xF2D56790AB41C2A2ULL, 0xFAE27299423FB9C3ULL },
+    { 0x97C560BA6B0919A5ULL, 0xDCCD879FC967D41AULL },
+    { 0xBDB6B8E905CB600FULL, 0x5400E987BBC1C920ULL },
+    { 0xED246723473E3813ULL, 0x290123E9AAB23B68ULL },
+    { 0x9436C0760C86E30BULL, 0xF9A0B6720AAF6521ULL },
+    { 0xB94470938FA89BCEULL, 0xF808E40E8D5B3E69ULL },
+    { 0xE7958CB87392C2C2ULL, 0xB60B1D1230B20E04ULL },
+    { 0x90BD77F3483BB9B9ULL, 0xB1C6F22B5E6F48C2ULL },
+    { 0xB4ECD5F01A4AA828ULL, 0x1E38AEB6360B1AF3ULL },
+    { 0xE2280B6C20DD5232ULL, 0x25C6DA63C38DE1B0ULL },
+    { 0x8D590723948A535FULL, 0x579C487E5A38AD0EULL },
+    { 0xB0AF48EC79ACE837ULL, 0x2D835A9DF0C6D851ULL },
+    { 0xDCDB1B2798182244ULL, 0xF8E431456CF88E65ULL },
+    { 0x8A08F0F8BF0F156BULL, 0x1B8E9ECB641B58FFULL },
+    { 0xAC8B2D36EED2DAC5ULL, 0xE272467E3D222F3FULL },
+    { 0xD7ADF884AA879177ULL, 0x5B0ED81DCC6ABB0FULL },
+    { 0x86CCBB52EA94BAEAULL, 0x98E947129FC2B4E9ULL },
+    { 0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL },
+    { 0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL },
+    { 0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL },
+    { 0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL },
+    { 0xCDB02555653131B6ULL, 0x3792F412CB06794DULL },
+    { 0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL },
+    { 0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL },
+    { 0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL },
+    { 0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL },
+    { 0x9CED737BB6C4183DULL, 0x55464DD69685606BULL },
+    { 0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL },
+    { 0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL },
+    { 0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL },
+    { 0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL },
+    { 0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL },
+    { 0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL },
+    { 0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL },
+    { 0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL },
+    { 0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL },
+    { 0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL },
+    { 0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL },
+    { 0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL },
+    { 0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL },
+    { 0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL },
+    { 0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL },
+    { 0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL },
+    { 0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL },
+    { 0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL },
+    { 0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL },
+    { 0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL },
+    { 0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL },
+    { 0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL },
+    { 0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL },
+    { 0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL },
+    { 0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL },
+    { 0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL },
+    { 0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL },
+    { 0x9E74D1B791E07E48ULL, 0x775EA264CF55347DULL },
+    { 0xC612062576589DDAULL, 0x95364AFE032A819DULL },
+    { 0xF79687AED3EEC551ULL, 0x3A83DDBD83F52204ULL },
+    { 0x9ABE14CD44753B52ULL, 0xC4926A9672793542ULL },
+    { 0xC16D9A0095928A27ULL, 0x75B7053C0F178293ULL },
+    { 0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6338ULL },
+    { 0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E03ULL },
+    { 0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF584ULL },
+    { 0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E5ULL },
+    { 0x9392EE8E921D5D07ULL, 0x3AFF322E62439FCFULL },
+    { 0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C2ULL },
+    { 0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B3ULL },
+    { 0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A10ULL },
+    { 0xB424DC35095CD80FULL, 0x538484C19EF38C94ULL },
+    { 0xE12E13424BB40E13ULL, 0x2865A5F206B06FB9ULL },
+    { 0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D3ULL },
+    { 0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D748ULL },
+    { 0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1BULL },
+    { 0x89705F4136B4A597ULL, 0x31680A88F8953030ULL },
+    { 0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3DULL },
+    { 0xD6BF94D5E57A42BCULL, 0x3D32907604691B4CULL },
+    { 0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B10FULL },
+    { 0xA7C5AC471B478423ULL, 0x0FCF80DC33721D53ULL },
+    { 0xD1B71758E219652BULL, 0xD3C36113404EA4A8ULL },
+    { 0x83126E978D4FDF3BULL, 0x645A1CAC083126E9ULL },
+    { 0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A3ULL },
+    { 0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCCULL },
+    { 0x8000000000000000ULL, 0x0000000000000000ULL },
+    { 0xA000000000000000ULL, 0x0000000000000000ULL },
+    { 0xC800000000000000ULL, 0x0000000000000000ULL },
+    { 0xFA00000000000000ULL, 0x0000000000000000ULL },
+    { 0x9C40000000000000ULL, 0x0000000000000000ULL },
+    { 0xC350000000000000ULL, 0x0000000000000000ULL },
+    { 0xF424000000000000ULL, 0x0000000000000000ULL },
+    { 0x9896800000000000ULL, 0x0000000000000000ULL },
+    { 0xBEBC200000000000ULL, 0x0000000000000000ULL },
+    { 0xEE6B280000000000ULL, 0x0000000000000000ULL },
+    { 0x9502F90000000000ULL, 0x0000000000000000ULL },
+    { 0xBA43B74000000000ULL, 0x0000000000000000ULL },
+    { 0xE8D4A51000000000ULL, 0x0000000000000000ULL },
+    { 0x9184E72A00000000ULL, 0x0000000000000000ULL },
+    { 0xB5E620F480000000ULL, 0x0000000000000000ULL },
+    { 0xE35FA931A0000000ULL, 0x0000000000000000ULL },
+    { 0x8E1BC9BF04000000ULL, 0x0000000000000000ULL },
+    { 0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL },
+    { 0xDE0B6B3A76400000ULL, 0x0000000000000000ULL },
+    { 0x8AC7230489E80000ULL, 0x0000000000000000ULL },
+    { 0xAD78EBC5AC620000ULL, 0x0000000000000000ULL },
+    { 0xD8D726B7177A8000ULL, 0x0000000000000000ULL },
+    { 0x878678326EAC9000ULL, 0x0000000000000000ULL },
+    { 0xA968163F0A57B400ULL, 0x0000000000000000ULL },
+    { 0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL },
+    { 0x84595161401484A0ULL, 0x0000000000000000ULL },
+    { 0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL },
+    { 0xCECB8F27F4200F3AULL, 0x0000000000000000ULL },
+    { 0x813F3978F8940984ULL, 0x4000000000000000ULL },
+    { 0xA18F07D736B90BE5ULL, 0x5000000000000000ULL },
+    { 0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL },
+    { 0xFC6F7C4045812296ULL, 0x4D00000000000000ULL },
+    { 0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL },
+    { 0xC5371912364CE305ULL, 0x6C28000000000000ULL },
+    { 0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL },
+    { 0x9A130B963A6C115CULL, 0x3C7F400000000000ULL },
+    { 0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL },
+    { 0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL },
+    { 0x96769950B50D88F4ULL, 0x1314448000000000ULL },
+    { 0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL },
+    { 0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL },
+    { 0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL },
+    { 0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL },
+    { 0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL },
+    { 0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL },
+    { 0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL },
+    { 0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL },
+    { 0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL },
+    { 0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL },
+    { 0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL },
+    { 0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL },
+    { 0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL },
+    { 0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL },
+    { 0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL },
+    { 0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL },
+    { 0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL },
+    { 0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL },
+    { 0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL },
+    { 0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL },
+    { 0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL },
+    { 0x9F4F2726179A2245ULL, 0x01D762422C946590ULL },
+    { 0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL },
+    { 0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL },
+    { 0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL },
+    { 0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL },
+    { 0xF316271C7FC3908AULL, 0x8BEF464E3945EF7AULL },
+    { 0x97EDD871CFDA3A56ULL, 0x97758BF0E3CBB5ACULL },
+    { 0xBDE94E8E43D0C8ECULL, 0x3D52EEED1CBEA317ULL },
+    { 0xED63A231D4C4FB27ULL, 0x4CA7AAA863EE4BDDULL },
+    { 0x945E455F24FB1CF8ULL, 0x8FE8CAA93E74EF6AULL },
+    { 0xB975D6B6EE39E436ULL, 0xB3E2FD538E122B44ULL },
+    { 0xE7D34C64A9C85D44ULL, 0x60DBBCA87196B616ULL },
+    { 0x90E40FBEEA1D3A4AULL, 0xBC8955E946FE31CDULL },
+    { 0xB51D13AEA4A488DDULL, 0x6BABAB6398BDBE41ULL },
+    { 0xE264589A4DCDAB14ULL, 0xC696963C7EED2DD1ULL },
+    { 0x8D7EB76070A08AECULL, 0xFC1E1DE5CF543CA2ULL },
+    { 0xB0DE65388CC8ADA8ULL, 0x3B25A55F43294BCBULL },
+    { 0xDD15FE86AFFAD912ULL, 0x49EF0EB713F39EBEULL },
+    { 0x8A2DBF142DFCC7ABULL, 0x6E3569326C784337ULL },
+    { 0xACB92ED9397BF996ULL, 0x49C2C37F07965404ULL },
+    { 0xD7E77A8F87DAF7FBULL, 0xDC33745EC97BE906ULL },
+    { 0x86F0AC99B4E8DAFDULL, 0x69A028BB3DED71A3ULL },
+    { 0xA8ACD7C0222311BCULL, 0xC40832EA0D68CE0CULL },
+    { 0xD2D80DB02AABD62BULL, 0xF50A3FA490C30190ULL },
+    { 0x83C7088E1AAB65DBULL, 0x792667C6DA79E0FAULL },
+    { 0xA4B8CAB1A1563F52ULL, 0x577001B891185938ULL },
+    { 0xCDE6FD5E09ABCF26ULL, 0xED4C0226B55E6F86ULL },
+    { 0x80B05E5AC60B6178ULL, 0x544F8158315B05B4ULL },
+    { 0xA0DC75F1778E39D6ULL, 0x696361AE3DB1C721ULL },
+    { 0xC913936DD571C84CULL, 0x03BC3A19CD1E38E9ULL },
+    { 0xFB5878494ACE3A5FULL, 0x04AB48A04065C723ULL },
+    { 0x9D174B2DCEC0E47BULL, 0x62EB0D64283F9C76ULL },
+    { 0xC45D1DF942711D9AULL, 0x3BA5D0BD324F8394ULL },
+    { 0xF5746577930D6500ULL, 0xCA8F44EC7EE36479ULL },
+    { 0x9968BF6ABBE85F20ULL, 0x7E998B13CF4E1ECBULL },
+    { 0xBFC2EF456AE276E8ULL, 0x9E3FEDD8C321A67EULL },
+    { 0xEFB3AB16C59B14A2ULL, 0xC5CFE94EF3EA101EULL },
+    { 0x95D04AEE3B80ECE5ULL, 0xBBA1F1D158724A12ULL },
+    { 0xBB445DA9CA61281FULL, 0x2A8A6E45AE8EDC97ULL },
+    { 0xEA1575143CF97226ULL, 0xF52D09D71A3293BDULL },
+    { 0x924D692CA61BE758ULL, 0x593C2626705F9C56ULL },
+    { 0xB6E0C377CFA2E12EULL, 0x6F8B2FB00C77836CULL },
+    { 0xE498F455C38B997AULL, 0x0B6DFB9C0F956447ULL },
+    { 0x8EDF98B59A373FECULL, 0x4724BD4189BD5EACULL },
+    { 0xB2977EE300C50FE7ULL, 0x58EDEC91EC2CB657ULL },
+    { 0xDF3D5E9BC0F653E1ULL, 0x2F2967B66737E3EDULL },
+    { 0x8B865B215899F46CULL, 0xBD79E0D20082EE74ULL },
+    { 0xAE67F1E9AEC07187ULL, 0xECD8590680A3AA11ULL },
+    { 0xDA01EE641A708DE9ULL, 0xE80E6F4820CC9495ULL },
+    { 0x884134FE908658B2ULL, 0x3109058D147FDCDDULL },
+    { 0xAA51823E34A7EEDEULL, 0xBD4B46F0599FD415ULL },
+    { 0xD4E5E2CDC1D1EA96ULL, 0x6C9E18AC7007C91AULL },
+    { 0x850FADC09923329EULL, 0x03E2CF6BC604DDB0ULL },
+    { 0xA6539930BF6BFF45ULL, 0x84DB8346B786151CULL },
+    { 0xCFE87F7CEF46FF16ULL, 0xE612641865679A63ULL },
+    { 0x81F14FAE158C5F6EULL, 0x4FCB7E8F3F60C07EULL },
+    { 0xA26DA3999AEF7749ULL, 0xE3BE5E330F38F09DULL },
+    { 0xCB090C8001AB551CULL, 0x5CADF5BFD3072CC5ULL },
+    { 0xFDCB4FA002162A63ULL, 0x73D9732FC7C8F7F6ULL },
+    { 0x9E9F11C4014DDA7EULL, 0x2867E7FDDCDD9AFAULL },
+    { 0xC646D63501A1511DULL, 0xB281E1FD541501B8ULL },
+    { 0xF7D88BC24209A565ULL, 0x1F225A7CA91A4226ULL },
+    { 0x9AE757596946075FULL, 0x3375788DE9B06958ULL },
+    { 0xC1A12D2FC3978937ULL, 0x0052D6B1641C83AEULL },
+    { 0xF209787BB47D6B84ULL, 0xC0678C5DBD23A49AULL },
+    { 0x9745EB4D50CE6332ULL, 0xF840B7BA963646E0ULL },
+    { 0xBD176620A501FBFFULL, 0xB650E5A93BC3D898ULL },
+    { 0xEC5D3FA8CE427AFFULL, 0xA3E51F138AB4CEBEULL },
+    { 0x93BA47C980E98CDFULL, 0xC66F336C36B10137ULL },
+    { 0xB8A8D9BBE123F017ULL, 0xB80B0047445D4184ULL },
+    { 0xE6D3102AD96CEC1DULL, 0xA60DC059157491E5ULL },
+    { 0x9043EA1AC7E41392ULL, 0x87C89837AD68DB2FULL },
+    { 0xB454E4A179DD1877ULL, 0x29BABE4598C311FBULL },
+    { 0xE16A1DC9D8545E94ULL, 0xF4296DD6FEF3D67AULL },
+    { 0x8CE2529E2734BB1DULL, 0x1899E4A65F58660CULL },
+    { 0xB01AE745B101E9E4ULL, 0x5EC05DCFF72E7F8FULL },
+    { 0xDC21A1171D42645DULL, 0x76707543F4FA1F73ULL },
+    { 0x899504AE72497EBAULL, 0x6A06494A791C53A8ULL },
+    { 0xABFA45DA0EDBDE69ULL, 0x0487DB9D17636892ULL },
+    { 0xD6F8D7509292D603ULL, 0x45A9D2845D3C42B6ULL },
+    { 0x865B86925B9BC5C2ULL, 0x0B8A2392BA45A9B2ULL },
+    { 0xA7F26836F282B732ULL, 0x8E6CAC7768D7141EULL },
+    { 0xD1EF0244AF2364FFULL, 0x3207D795430CD926ULL },
+    { 0x8335616AED761F1FULL, 0x7F44E6BD49E807B8ULL },
+    { 0xA402B9C5A8D3A6E7ULL, 0x5F16206C9C6209A6ULL },
+    { 0xCD036837130890A1ULL, 0x36DBA887C37A8C0FULL },
+    { 0x802221226BE55A64ULL, 0xC2494954DA2C9789ULL },
+    { 0xA02AA96B06DEB0FDULL, 0xF2DB9BAA10B7BD6CULL },
+    { 0xC83553C5C8965D3DULL, 0x6F92829494E5ACC7ULL },
+    { 0xFA42A8B73ABBF48CULL, 0xCB772339BA1F17F9ULL },
+    { 0x9C69A97284B578D7ULL, 0xFF2A760414536EFBULL },
+    { 0xC38413CF25E2D70DULL, 0xFEF5138519684ABAULL },
+    { 0xF46518C2EF5B8CD1ULL, 0x7EB258665FC25D69ULL },
+    { 0x98BF2F79D5993802ULL, 0xEF2F773FFBD97A61ULL },
+    { 0xBEEEFB584AFF8603ULL, 0xAAFB550FFACFD8FAULL },
+    { 0xEEAABA2E5DBF6784ULL, 0x95BA2A53F983CF38ULL },
+    { 0x952AB45CFA97A0B2ULL, 0xDD945A747BF26183ULL },
+    { 0xBA756174393D88DFULL, 0x94F971119AEEF9E4ULL },
+    { 0xE912B9D1478CEB17ULL, 0x7A37CD5601AAB85DULL },
+    { 0x91ABB422CCB812EEULL, 0xAC62E055C10AB33AULL },
+    { 0xB616A12B7FE617AAULL, 0x577B986B314D6009ULL },
+    { 0xE39C49765FDF9D94ULL, 0xED5A7E85FDA0B80BULL },
+    { 0x8E41ADE9FBEBC27DULL, 0x14588F13BE847307ULL },
+    { 0xB1D219647AE6B31CULL, 0x596EB2D8AE258FC8ULL },
+    { 0xDE469FBD99A05FE3ULL, 0x6FCA5F8ED9AEF3BBULL },
+    { 0x8AEC23D680043BEEULL, 0x25DE7BB9480D5854ULL },
+    { 0xADA72CCC20054AE9ULL, 0xAF561AA79A10AE6AULL },
+    { 0xD910F7FF28069DA4ULL, 0x1B2BA1518094DA04ULL },
+    { 0x87AA9AFF79042286ULL, 0x90FB44D2F05D0842ULL },
+    { 0xA99541BF57452B28ULL, 0x353A1607AC744A53ULL },
+    { 0xD3FA922F2D1675F2ULL, 0x42889B8997915CE8ULL },
+    { 0x847C9B5D7C2E09B7ULL, 0x69956135FEBADA11ULL },
+    { 0xA59BC234DB398C25ULL, 0x43FAB9837E699095ULL },
+    { 0xCF02B2C21207EF2EULL, 0x94F967E45E03F4BBULL },
+    { 0x8161AFB94B44F57DULL, 0x1D1BE0EEBAC278F5ULL },
+    { 0xA1BA1BA79E1632DCULL, 0x6462D92A69731732ULL },
+    { 0xCA28A291859BBF93ULL, 0x7D7B8F7503CFDCFEULL },
+    { 0xFCB2CB35E702AF78ULL, 0x5CDA735244C3D43EULL },
+    { 0x9DEFBF01B061ADABULL, 0x3A0888136AFA64A7ULL },
+    { 0xC56BAEC21C7A1916ULL, 0x088AAA1845B8FDD0ULL },
+    { 0xF6C69A72A3989F5BULL, 0x8AAD549E57273D45ULL },
+    { 0x9A3C2087A63F6399ULL, 0x36AC54E2F678864BULL },
+    { 0xC0CB28A98FCF3C7FULL, 0x84576A1BB416A7DDULL },
+    { 0xF0FDF2D3F3C30B9FULL, 0x656D44A2A11C51D5ULL },
+    { 0x969EB7C47859E743ULL, 0x9F644AE5A4B1B325ULL },
+    { 0xBC4665B596706114ULL, 0x873D5D9F0DDE1FEEULL },
+    { 0xEB57FF22FC0C7959ULL, 0xA90CB506D155A7EAULL },
+    { 0x9316FF75DD87CBD8ULL, 0x09A7F12442D588F2ULL },
+    { 0xB7DCBF5354E9BECEULL, 0x0C11ED6D538AEB2FULL },
+    { 0xE5D3EF282A242E81ULL, 0x8F1668C8A86DA5FAULL },
+    { 0x8FA475791A569D10ULL, 0xF96E017D694487BCULL },
+    { 0xB38D92D760EC4455ULL, 0x37C981DCC395A9ACULL },
+    { 0xE070F78D3927556AULL, 0x85BBE253F47B1417ULL },
+    { 0x8C469AB843B89562ULL, 0x93956D7478CCEC8EULL },
+    { 0xAF58416654A6BABBULL, 0x387AC8D1970027B2ULL },
+    { 0xDB2E51BFE9D0696AULL, 0x06997B05FCC0319EULL },
+    { 0x88FCF317F22241E2ULL, 0x441FECE3BDF81F03ULL },
+    { 0xAB3C2FDDEEAAD25AULL, 0xD527E81CAD7626C3ULL },
+    { 0xD60B3BD56A5586F1ULL, 0x8A71E223D8D3B074ULL },
+    { 0x85C7056562757456ULL, 0xF6872D5667844E49ULL },
+    { 0xA738C6BEBB12D16CULL, 0xB428F8AC016561DBULL },
+    { 0xD106F86E69D785C7ULL, 0xE13336D701BEBA52ULL },
+    { 0x82A45B450226B39CULL, 0xECC0024661173473ULL },
+    { 0xA34D721642B06084ULL, 0x27F002D7F95D0190ULL },
+    { 0xCC20CE9BD35C78A5ULL, 0x31EC038DF7B441F4ULL },
+    { 0xFF290242C83396CEULL, 0x7E67047175A15271ULL },
+    { 0x9F79A169BD203E41ULL, 0x0F0062C6E984D386ULL },
+    { 0xC75809C42C684DD1ULL, 0x52C07B78A3E60868ULL },
+    { 0xF92E0C3537826145ULL, 0xA7709A56CCDF8A82ULL },
+    { 0x9BBCC7A142B17CCBULL, 0x88A66076400BB691ULL },
+    { 0xC2ABF989935DDBFEULL, 0x6ACFF893D00EA435ULL },
+    { 0xF356F7EBF83552FEULL, 0x0583F6B8C4124D43ULL },
+    { 0x98165AF37B2153DEULL, 0xC3727A337A8B704AULL },
+    { 0xBE1BF1B059E9A8D6ULL, 0x744F18C0592E4C5CULL },
+    { 0xEDA2EE1C7064130CULL, 0x1162DEF06F79DF73ULL },
+    { 0x9485D4D1C63E8BE7ULL, 0x8ADDCB5645AC2BA8ULL },
+    { 0xB9A74A0637CE2EE1ULL, 0x6D953E2BD7173692ULL },
+    { 0xE8111C87C5C1BA99ULL, 0xC8FA8DB6CCDD0437ULL },
+    { 0x910AB1D4DB9914A0ULL, 0x1D9C9892400A22A2ULL },
+    { 0xB54D5E4A127F59C8ULL, 0x2503BEB6D00CAB4BULL },
+    { 0xE2A0B5DC971F303AULL, 0x2E44AE64840FD61DULL },
+    { 0x8DA471A9DE737E24ULL, 0x5CEAECFED289E5D2ULL },
+    { 0xB10D8E1456105DADULL, 0x7425A83E872C5F47ULL },
+    { 0xDD50F1996B947518ULL, 0xD12F124E28F77719ULL },
+    { 0x8A5296FFE33CC92FULL, 0x82BD6B70D99AAA6FULL },
+    { 0xACE73CBFDC0BFB7BULL, 0x636CC64D1001550BULL },
+    { 0xD8210BEFD30EFA5AULL, 0x3C47F7E05401AA4EULL },
+    { 0x8714A775E3E95C78ULL, 0x65ACFAEC34810A71ULL },
+    { 0xA8D9D1535CE3B396ULL, 0x7F1839A741A14D0DULL },
+    { 0xD31045A8341CA07CULL, 0x1EDE48111209A050ULL },
+    { 0x83EA2B892091E44DULL, 0x934AED0AAB460432ULL },
+    { 0xA4E4B66B68B65D60ULL, 0xF81DA84D5617853FULL },
+    { 0xCE1DE40642E3F4B9ULL, 0x36251260AB9D668EULL },
+    { 0x80D2AE83E9CE78F3ULL, 0xC1D72B7C6B426019ULL },
+    { 0xA1075A24E4421730ULL, 0xB24CF65B8612F81FULL },
+    { 0xC94930AE1D529CFCULL, 0xDEE033F26797B627ULL },
+    { 0xFB9B7CD9A4A7443CULL, 0x169840EF017DA3B1ULL },
+    { 0x9D412E0806E88AA5ULL, 0x8E1F289560EE864EULL },
+    { 0xC491798A08A2AD4EULL, 0xF1A6F2BAB92A27E2ULL },
+    { 0xF5B5D7EC8ACB58A2ULL, 0xAE10AF696774B1DBULL },
+    { 0x9991A6F3D6BF1765ULL, 0xACCA6DA1E0A8EF29ULL },
+    { 0xBFF610B0CC6EDD3FULL, 0x17FD090A58D32AF3ULL },
+    { 0xEFF394DCFF8A948EULL, 0xDDFC4B4CEF07F5B0ULL },
+    { 0x95F83D0A1FB69CD9ULL, 0x4ABDAF101564F98EULL },
+    { 0xBB764C4CA7A4440FULL, 0x9D6D1AD41ABE37F1ULL },
+    { 0xEA53DF5FD18D5513ULL, 0x84C86189216DC5EDULL },
+    { 0x92746B9BE2F8552CULL, 0x32FD3CF5B4E49BB4ULL },
+    { 0xB7118682DBB66A77ULL, 0x3FBC8C33221DC2A1ULL },
+    { 0xE4D5E82392A40515ULL, 0x0FABAF3FEAA5334AULL },
+    { 0x8F05B1163BA6832DULL, 0x29CB4D87F2A7400EULL },
+    { 0xB2C71D5BCA9023F8ULL, 0x743E20E9EF511012ULL },
+    { 0xDF78E4B2BD342CF6ULL, 0x914DA9246B255416ULL },
+    { 0x8BAB8EEFB6409C1AULL, 0x1AD089B6C2F7548EULL },
+    { 0xAE9672ABA3D0C320ULL, 0xA184AC2473B529B1ULL },
+    { 0xDA3C0F568CC4F3E8ULL, 0xC9E5D72D90A2741EULL },
+    { 0x8865899617FB1871ULL, 0x7E2FA67C7A658892ULL },
+    { 0xAA7EEBFB9DF9DE8DULL, 0xDDBB901B98FEEAB7ULL },
+    { 0xD51EA6FA85785631ULL, 0x552A74227F3EA565ULL },
+    { 0x8533285C936B35DEULL, 0xD53A88958F87275FULL },
+    { 0xA67FF273B8460356ULL, 0x8A892ABAF368F137ULL },
+    { 0xD01FEF10A657842CULL, 0x2D2B7569B0432D85ULL },
+    { 0x8213F56A67F6B29BULL, 0x9C3B29620E29FC73ULL },
+    { 0xA298F2C501F45F42ULL, 0x8349F3BA91B47B8FULL },
+    { 0xCB3F2F7642717713ULL, 0x241C70A936219A73ULL },
+    { 0xFE0EFB53D30DD4D7ULL, 0xED238CD383AA0110ULL },
+    { 0x9EC95D1463E8A506ULL, 0xF4363804324A40AAULL },
+    { 0xC67BB4597CE2CE48ULL, 0xB143C6053EDCD0D5ULL },
+    { 0xF81AA16FDC1B81DAULL, 0xDD94B7868E94050AULL },
+    { 0x9B10A4E5E9913128ULL, 0xCA7CF2B4191C8326ULL },
+    { 0xC1D4CE1F63F57D72ULL, 0xFD1C2F611F63A3F0ULL },
+    { 0xF24A01A73CF2DCCFULL, 0xBC633B39673C8CECULL },
+    { 0x976E41088617CA01ULL, 0xD5BE0503E085D813ULL },
+    { 0xBD49D14AA79DBC82ULL, 0x4B2D8644D8A74E18ULL },
+    { 0xEC9C459D51852BA2ULL, 0xDDF8E7D60ED1219EULL },
+    { 0x93E1AB8252F33B45ULL, 0xCABB90E5C942B503ULL },
+    { 0xB8DA1662E7B00A17ULL, 0x3D6A751F3B936243ULL },
+    { 0xE7109BFBA19C0C9DULL, 0x0CC512670A783AD4ULL },
+    { 0x906A617D450187E2ULL, 0x27FB2B80668B24C5ULL },
+    { 0xB484F9DC9641E9DAULL, 0xB1F9F660802DEDF6ULL },
+    { 0xE1A63853BBD26451ULL, 0x5E7873F8A0396973ULL },
+    { 0x8D07E33455637EB2ULL, 0xDB0B487B6423E1E8ULL },
+    { 0xB049DC016ABC5E5FULL, 0x91CE1A9A3D2CDA62ULL },
+    { 0xDC5C5301C56B75F7ULL, 0x7641A140CC7810FBULL },
+    { 0x89B9B3E11B6329BAULL, 0xA9E904C87FCB0A9DULL },
+    { 0xAC2820D9623BF429ULL, 0x546345FA9FBDCD44ULL },
+    { 0xD732290FBACAF133ULL, 0xA97C177947AD4095ULL },
+    { 0x867F59A9D4BED6C0ULL, 0x49ED8EABCCCC485DULL },
+    { 0xA81F301449EE8C70ULL, 0x5C68F256BFFF5A74ULL },
+    { 0xD226FC195C6A2F8CULL, 0x73832EEC6FFF3111ULL },
+    { 0x83585D8FD9C25DB7ULL, 0xC831FD53C5FF7EABULL },
+    { 0xA42E74F3D032F525ULL, 0xBA3E7CA8B77F5E55ULL },
+    { 0xCD3A1230C43FB26FULL, 0x28CE1BD2E55F35EBULL },
+    { 0x80444B5E7AA7CF85ULL, 0x7980D163CF5B81B3ULL },
+    { 0xA0555E361951C366ULL, 0xD7E105BCC332621FULL },
+    { 0xC86AB5C39FA63440ULL, 0x8DD9472BF3FEFAA7ULL },
+    { 0xFA856334878FC150ULL, 0xB14F98F6F0FEB951ULL },
+    { 0x9C935E00D4B9D8D2ULL, 0x6ED1BF9A569F33D3ULL },
+    { 0xC3B8358109E84F07ULL, 0x0A862F80EC4700C8ULL },
+    { 0xF4A642E14C6262C8ULL, 0xCD27BB612758C0FAULL },
+    { 0x98E7E9CCCFBD7DBDULL, 0x8038D51CB897789CULL },
+    { 0xBF21E44003ACDD2CULL, 0xE0470A63E6BD56C3ULL },
+    { 0xEEEA5D5004981478ULL, 0x1858CCFCE06CAC74ULL },
+    { 0x95527A5202DF0CCBULL, 0x0F37801E0C43EBC8ULL },
+    { 0xBAA718E68396CFFDULL, 0xD30560258F54E6BAULL },
+    { 0xE950DF20247C83FDULL, 0x47C6B82EF32A2069ULL },
+    { 0x91D28B7416CDD27EULL, 0x4CDC331D57FA5441ULL },
+    { 0xB6472E511C81471DULL, 0xE0133FE4ADF8E952ULL },
+    { 0xE3D8F9E563A198E5ULL, 0x58180FDDD97723A6ULL },
+    { 0x8E679C2F5E44FF8FULL, 0x570F09EAA7EA7648ULL },
+};
+
+struct float_format {
+    u32 mantissa_bits;
+    i32 bias;
+    u32 max_exponent;
+};
+
+static constexpr float_format f64_format = {52, 1023, 0x7FF};
+static constexpr float_format f32_format = {23, 127, 0xFF};
+
+// Eisel-Lemire: exact result for `mantissa * 10^exp10` in most cases;
+// returns false when the 128-bit approximation is not conclusive.
+inline bool eisel_lemire(u64 mantissa, i32 exp10, const float_format& fmt, u64& bits) {
+    u32 clz = __builtin_clzll(mantissa);
+    mantissa <<= clz;
+    u64 exp2 = (u64)(((217706 * exp10) >> 16) + 64 + fmt.bias) - clz;
+
+    const u64* pow = pow10_128[exp10 - pow10_min];
+    u32 shift = 64 - fmt.mantissa_bits - 3;
+    u64 low_mask = (1ULL << shift) - 1;
+    u64 hi;
+    u64 lo = mul_128(mantissa, pow[0], hi);
+    if((hi & low_mask) == low_mask && lo + mantissa < mantissa) {
+        u64 y_hi;
+        u64 y_lo = mul_128(mantissa, pow[1], y_hi);
+        u64 merged_hi = hi;
+        u64 merged_lo = lo + y_hi;
+        if(merged_lo < lo) merged_hi++;
+        if((merged_hi & low_mask) == low_mask && merged_lo + 1 == 0 && y_lo + mantissa < mantissa) return false;
+        hi = merged_hi;
+        lo = merged_lo;
+    }
+
+    u64 msb = hi >> 63;
+    u64 result = hi >> (msb + shift);
+    exp2 -= 1 ^ msb;
+    if(lo == 0 && (hi & low_mask) == 0 && (result & 3) == 1) return false;
+
+    result += result & 1;
+    result >>= 1;
+    if(result >> (fmt.mantissa_bits + 1)) {
+        result >>= 1;
+        exp2++;
+    }
+    if(exp2 - 1 >= fmt.max_exponent - 1) return false;
+    bits = (exp2 << fmt.mantissa_bits) | (result & ((1ULL << fmt.mantissa_bits) - 1));
+    return true;
+}
+
+// Arbitrary-precision decimal used when the fast paths are inconclusive
+// (same approach as Go's strconv slow path).
+struct decimal {
+    static constexpr i32 max_digits = 800;
+    u8 d[max_digits + 32];
+    i32 nd;
+    i32 dp;
+    bool trunc;
+
+    decimal() : nd(0), dp(0), trunc(false) {}
+
+    void trim() {
+        while(nd > 0 && d[nd - 1] == 0) nd--;
+        if(nd == 0) dp = 0;
+    }
+
+    void shift_right(u32 k) {
+        i32 r = 0;
+        i32 w = 0;
+        u64 n = 0;
+        for(; (n >> k) == 0; r++) {
+            if(r >= nd) {
+                if(n == 0) {
+                    nd = 0;
+                    return;
+                }
+                while((n >> k) == 0) {
+                    n *= 10;
+                    r++;
+                }
+                break;
+            }
+            n = n * 10 + d[r];
+        }
+        dp -= r - 1;
+        u64 mask = (1ULL << k) - 1;
+        for(; r < nd; r++) {
+            u64 c = d[r];
+            d[w++] = (u8)(n >> k);
+            n = (n & mask) * 10 + c;
+        }
+        while(n > 0) {
+            u64 dig = n >> k;
+            n &= mask;
+            if(w < max_digits) {
+                d[w++] = (u8)dig;
+            } else if(dig > 0) {
+                trunc = true;
+            }
+            n *= 10;
+        }
+        nd = w;
+        trim();
+    }
+
+    void shift_left(u32 k) {
+        // k <= 60 adds at most 19 digits; write with that headroom, then
+        // close the gap left by the over-estimate.
+        const i32 headroom = 19;
+        i32 w = nd + headroom;
+        u64 n = 0;
+        for(i32 r = nd - 1; r >= 0; r--) {
+            n += (u64)d[r] << k;
+            d[--w] = (u8)(n % 10);
+            n /= 10;
+        }
+        while(n > 0) {
+            d[--w] = (u8)(n % 10);
+            n /= 10;
+        }
+        i32 total = nd + headroom - w;
+        for(i32 i = 0; i < total; i++) d[i] = d[w + i];
+        dp += total - nd;
+        nd = total;
+        if(nd > max_digits) {
+            for(i32 i = max_digits; i < nd; i++) {
+                if(d[i]) trunc = true;
+            }
+            nd = max_digits;
+        }
+        trim();
+    }
+
+    void shift(i32 k) {
+        if(nd == 0) return;
+        const i32 max_shift = 60;
+        for(; k > max_shift; k -= max_shift) shift_left(max_shift);
+        for(; k < -max_shift; k += max_shift) shift_right(max_shift);
+        if(k > 0) shift_left((u32)k);
+        if(k < 0) shift_right((u32)-k);
+    }
+
+    bool round_up_at(i32 i) const {
+        if(i < 0 || i >= nd) return false;
+        if(d[i] == 5 && i + 1 == nd) {
+            if(trunc) return true;
+            return i > 0 && (d[i - 1] & 1);
+        }
+        return d[i] >= 5;
+    }
+
+    u64 rounded_integer() const {
+        if(dp > 20) return ~0ULL;
+        u64 n = 0;
+        i32 i = 0;
+        for(; i < dp && i < nd; i++) n = n * 10 + d[i];
+        for(; i < dp; i++) n *= 10;
+        if(round_up_at(dp)) n++;
+        return n;
+    }
+
+    // Returns the biased exponent and mantissa bits; overflow yields infinity.
+    u64 to_bits(const float_format& fmt, bool& overflow) {
+        static constexpr i32 powtab[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+        overflow = false;
+        i32 min_exp = 1 - fmt.bias;
+        if(nd == 0 || dp < -330) return 0;
+        if(dp > 310) {
+            overflow = true;
+            return (u64)fmt.max_exponent << fmt.mantissa_bits;
+        }
+
+        i32 exp = 0;
+        while(dp > 0) {
+            i32 n = dp >= 9 ? 27 : powtab[dp];
+            shift(-n);
+            exp += n;
+        }
+        while(dp < 0 || (dp == 0 && d[0] < 5)) {
+            i32 n = -dp >= 9 ? 27 : powtab[-dp];
+            shift(n);
+            exp -= n;
+        }
+        exp--;
+
+        if(exp < min_exp) {
+            shift(-(min_exp - exp));
+            exp = min_exp;
+        }
+        if(exp + fmt.bias >= (i32)fmt.max_exponent) {
+            overflow = true;
+            return (u64)fmt.max_exponent << fmt.mantissa_bits;
+        }
+
+        shift((i32)fmt.mantissa_bits + 1);
+        u64 mant = rounded_integer();
+        if(mant == (2ULL << fmt.mantissa_bits)) {
+            mant >>= 1;
+            exp++;
+            if(exp + fmt.bias >= (i32)fmt.max_exponent) {
+                overflow = true;
+                return (u64)fmt.max_exponent << fmt.mantissa_bits;
+            }
+        }
+        u64 biased = (mant >> fmt.mantissa_bits) ? (u64)(exp + fmt.bias) : 0;
+        return (biased << fmt.mantissa_bits) | (mant & ((1ULL << fmt.mantissa_bits) - 1));
+    }
+};
+
+inline bool match_word(const char*& p, const char* last, const char* word) {
+    const char* q = p;
+    for(; *word; word++, q++) {
+        if(q == last || (*q | 0x20) != *word) return false;
+    }
+    p = q;
+    return true;
+}
+
+static constexpr f64 exact_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Parses to the raw bits of the nearest value in `fmt`, sign excluded.
+inline parse_error parse_float_bits(const char* first, const char* last, const char*& end,
+                                    const float_format& fmt, u64& bits, bool& negative) {
+    const char* p = first;
+    negative = false;
+    if(p < last && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    end = first;
+    bits = 0;
+
+    if(p < last && !is_digit(*p) && *p != '.') {
+        u64 special = (u64)fmt.max_exponent << fmt.mantissa_bits;
+        if(match_word(p, last, "nan")) {
+            bits = special | (1ULL << (fmt.mantissa_bits - 1));
+            end = p;
+            return parse_error::none;
+        }
+        if(match_word(p, last, "inf")) {
+            match_word(p, last, "inity");
+            bits = special;
+            end = p;
+            return parse_error::none;
+        }
+        return parse_error::invalid;
+    }
+
+    // Up to 19 significant digits go into `mantissa`; the rest only move the
+    // decimal point or mark the value as truncated.
+    const char* start = p;
+    u64 mantissa = 0;
+    i32 digits = 0;
+    i32 exp10 = 0;
+    bool truncated = false;
+    i32 exp_part = 0;
+    bool any_digit = false;
+
+    while(p < last && *p == '0') {
+        p++;
+        any_digit = true;
+    }
+    const char* int_start = p;
+    while(last - p >= 8 && is_eight_digits(load_u64_le(p)) && digits + 8 <= 19) {
+        mantissa = mantissa * 100000000 + parse_eight_digits(load_u64_le(p));
+        digits += 8;
+        p += 8;
+    }
+    while(p < last && is_digit(*p)) {
+        if(digits < 19) {
+            mantissa = mantissa * 10 + (u64)(*p - '0');
+            digits++;
+        } else {
+            exp10++;
+            if(*p != '0') truncated = true;
+        }
+        p++;
+    }
+    any_digit |= p != int_start;
+    if(p < last && *p == '.') {
+        p++;
+        const char* frac_start = p;
+        if(digits == 0) {
+            while(p < last && *p == '0') {
+                p++;
+                exp10--;
+            }
+        }
+        while(digits + 8 <= 19 && last - p >= 8 && is_eight_digits(load_u64_le(p))) {
+            mantissa = mantissa * 100000000 + parse_eight_digits(load_u64_le(p));
+            digits += 8;
+            exp10 -= 8;
+            p += 8;
+        }
+        while(p < last && is_digit(*p)) {
+            if(digits < 19) {
+                mantissa = mantissa * 10 + (u64)(*p - '0');
+                digits++;
+                exp10--;
+            } else if(*p != '0') {
+                truncated = true;
+            }
+            p++;
+        }
+        any_digit |= p != frac_start;
+    }
+    if(!any_digit) return parse_error::invalid;
+    const char* digits_end = p;
+
+    if(p < last && (*p | 0x20) == 'e') {
+        const char* q = p + 1;
+        bool exp_negative = false;
+        if(q < last && (*q == '-' || *q == '+')) exp_negative = *q++ == '-';
+        if(q < last && is_digit(*q)) {
+            i32 e = 0;
+            while(q < last && is_digit(*q)) {
+                if(e < 100000) e = e * 10 + (*q - '0');
+                q++;
+            }
+            exp_part = exp_negative ? -e : e;
+            exp10 += exp_part;
+            p = q;
+        }
+    }
+    end = p;
+
+    if(mantissa == 0) return parse_error::none;
+
+    // Clinger's fast path: both operands exact, one correctly rounded op.
+    u64 exact_limit = 1ULL << (fmt.mantissa_bits + 1);
+    i32 exact_exp = fmt.mantissa_bits == 52 ? 22 : 10;
+    if(!truncated && mantissa <= exact_limit && exp10 >= -exact_exp && exp10 <= exact_exp) {
+        if(fmt.mantissa_bits == 52) {
+            f64 v = (f64)mantissa;
+            v = exp10 < 0 ? v / exact_pow10[-exp10] : v * exact_pow10[exp10];
+            memcpy_simple(&bits, &v, sizeof(v));
+        } else {
+            f32 v = (f32)mantissa;
+            v = exp10 < 0 ? v / (f32)exact_pow10[-exp10] : v * (f32)exact_pow10[exp10];
+            u32 b;
+            memcpy_simple(&b, &v, sizeof(b));
+            bits = b;
+        }
+        return parse_error::none;
+    }
+
+    if(exp10 < pow10_min) return parse_error::none;
+    if(exp10 > pow10_max) {
+        bits = (u64)fmt.max_exponent << fmt.mantissa_bits;
+        return parse_error::out_of_range;
+    }
+
+    u64 fast_bits;
+    if(eisel_lemire(mantissa, exp10, fmt, fast_bits)) {
+        u64 upper_bits;
+        if(!truncated || (eisel_lemire(mantissa + 1, exp10, fmt, upper_bits) && upper_bits == fast_bits)) {
+            bits = fast_bits;
+            return parse_error::none;
+        }
+    }
+
+    decimal dec;
+    const char* q = start;
+    bool seen_point = false;
+    for(; q < digits_end; q++) {
+        if(*q == '.') {
+            seen_point = true;
+            continue;
+        }
+        if(*q == '0' && dec.nd == 0) {
+            if(seen_point) dec.dp--;
+            continue;
+        }
+        if(!seen_point) dec.dp++;
+        if(dec.nd < decimal::max_digits) {
+            dec.d[dec.nd++] = (u8)(*q - '0');
+        } else if(*q != '0') {
+            dec.trunc = true;
+        }
+    }
+    dec.dp += exp_part;
+    dec.trim();
+    bool overflow;
+    bits = dec.to_bits(fmt, overflow);
+    return overflow ? parse_error::out_of_range : parse_error::none;
+}
+
+}
+
+// Parses a number from [first, last) without allocating. Leading whitespace
+// is not skipped; an optional sign is accepted ('+' included). `end` points
+// past the consumed characters, or at `first` when nothing was parsed.
+// Out-of-range integers saturate, out-of-range floats become +-inf.
+template<typename T>
+parse_result<T> parse(const char* first, const char* last);
+
+template<>
+parse_result<i32> parse<i32>(const char* first, const char* last) {
+    return detail::parse_signed<i32>(first, last, 0x7FFFFFFFu);
+}
+
+template<>
+parse_result<u32> parse<u32>(const char* first, const char* last) {
+    return detail::parse_unsigned<u32>(first, last, 0xFFFFFFFFu);
+}
+
+template<>
+parse_result<i64> parse<i64>(const char* first, const char* last) {
+    return detail::parse_signed<i64>(first, last, 0x7FFFFFFFFFFFFFFFULL);
+}
+
+template<>
+parse_result<u64> parse<u64>(const char* first, const char* last) {
+    return detail::parse_unsigned<u64>(first, last, ~0ULL);
+}
+
+template<>
+parse_result<f64> parse<f64>(const char* first, const char* last) {
+    const char* end;
+    u64 bits;
+    bool negative;
+    parse_error error = detail::parse_float_bits(first, last, end, detail::f64_format, bits, negative);
+    if(negative) bits |= 1ULL << 63;
+    f64 value;
+    memcpy_simple(&value, &bits, sizeof(value));
+    return parse_result<f64>{value, end, error};
+}
+
+template<>
+parse_result<f32> parse<f32>(const char* first, const char* last) {
+    const char* end;
+    u64 bits;
+    bool negative;
+    parse_error error = detail::parse_float_bits(first, last, end, detail::f32_format, bits, negative);
+    u32 narrow = (u32)bits | (negative ? 0x80000000u : 0);
+    f32 value;
+    memcpy_simple(&value, &narrow, sizeof(value));
+    return parse_result<f32>{value, end, error};
+}
+
+template<typename T>
+parse_result<T> parse(const char* str) {
+    return parse<T>(str, str + strlen_simple(str));
+}
+
+template<typename T, typename A>
+parse_result<T> parse(const basic_string<A>& str) {
+    return parse<T>(str.c_str(), str.c_str() + str.length());
+}
+
+template<typename T>
+parse_result<T> parse(string_view str) {
+    return parse<T>(str.begin(), str.end());
+}
+
+template<typename T>
+parse_result<T> string_view::parse() const {
+    return raz::parse<T>(ptr, ptr + len);
+}
+
+#ifndef RAZ_ISTREAM_BUFFER_SIZE
+#define RAZ_ISTREAM_BUFFER_SIZE 65536
+#endif
+
+class istream {
+private:
+    char buf[RAZ_ISTREAM_BUFFER_SIZE];
+    u32 head;
+    u32 tail;
+    i32 fd;
+    bool eof_flag;
+    bool fail_flag;
+
+    bool fill() {
+        if(eof_flag) return false;
+        cout.flush();
+        long n = sys::read(fd, buf, RAZ_ISTREAM_BUFFER_SIZE);
+        RAZ_STAT(stats.istreams.record_io(n));
+        if(n <= 0) {
+            eof_flag = true;
+            return false;
+        }
+        head = 0;
+        tail = (u32)n;
+        return true;
+    }
+
+    static bool is_space(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+    bool read_char(char& c) {
+        if(head == tail && !fill()) return false;
+        c = buf[head++];
+        return true;
+    }
+
+    bool skip_space() {
+        while(true) {
+            while(head < tail) {
+                if(!is_space(buf[head])) return true;
+                head++;
+            }
+            if(!fill()) return false;
+        }
+    }
+
+    // Pulls in more input until the token at `head` ends inside the buffer,
+    // moving it to the front when needed. Returns the token's end.
+    u32 token_end() {
+        u32 end = head;
+        while(true) {
+            while(end < tail && !is_space(buf[end])) end++;
+            if(end < tail || eof_flag) return end;
+            if(head > 0) {
+                for(u32 i = head; i < tail; i++) buf[i - head] = buf[i];
+                end -= head;
+                tail -= head;
+                head = 0;
+            }
+            if(tail == RAZ_ISTREAM_BUFFER_SIZE) return end;
+            cout.flush();
+            long n = sys::read(fd, buf + tail, RAZ_ISTREAM_BUFFER_SIZE - tail);
+            RAZ_STAT(stats.istreams.record_io(n));
+            if(n <= 0) {
+                eof_flag = true;
+                return end;
+            }
+            tail += (u32)n;
+        }
+    }
+
+    template<typename T>
+    istream& read_number(T& num) {
+        if(!skip_space()) {
+            num = 0;
+            fail_flag = true;
+            return *this;
+        }
+        u32 end = token_end();
+        parse_result<T> r = parse<T>(buf + head, buf + end);
+        num = r.value;
+        if(r.error != parse_error::none) fail_flag = true;
+        head = (u32)(r.end - buf);
+        if(head < tail && is_space(buf[head])) head++;
+        return *this;
+    }
+
+public:
+    explicit istream(i32 in_fd = 0) : head(0), tail(0), fd(in_fd), eof_flag(false), fail_flag(false) {}
+
+    istream(const istream&) = delete;
+    istream& operator=(const istream&) = delete;
+
+    bool eof() const { return eof_flag && head == tail; }
+    bool fail() const { return fail_flag; }
+    explicit operator bool() const { return !fail_flag; }
+    void clear_error() { fail_flag = false; }
+
+    template<typename A>
+    istream& operator>>(basic_string<A>& str) {
+        str.clear();
+        if(!skip_space()) {
+            fail_flag = true;
+            return *this;
+        }
+        while(true) {
+            u32 start = head;
+            while(head < tail && !is_space(buf[head])) head++;
+            str.append(buf + start, head - start);
+            if(head < tail) {
+                head++;
+                break;
+            }
+            if(!fill()) break;
+        }
+        return *this;
+    }
+
+    istream& operator>>(i32& num) { return read_number(num); }
+    istream& operator>>(u32& num) { return read_number(num); }
+    istream& operator>>(i64& num) { return read_number(num); }
+    istream& operator>>(u64& num) { return read_number(num); }
+    istream& operator>>(f64& num) { return read_number(num); }
+    istream& operator>>(f32& num) { return read_number(num); }
+
+    istream& operator>>(char& c) {
+        if(!read_char(c)) {
+            c = '\0';
+            fail_flag = true;
+        }
+        return *this;
+    }
+
+    template<typename A>
+    istream& getline(basic_string<A>& str, char delim = '\n') {
+        str.clear();
+        if(head == tail && !fill()) {
+            fail_flag = true;
+            return *this;
+        }
+        while(true) {
+            u32 start = head;
+            while(head < tail && buf[head] != delim) head++;
+            str.append(buf + start, head - start);
+            if(head < tail) {
+                head++;
+                break;
+            }
+            if(!fill()) break;
+        }
+        return *this;
+    }
+};
+
+static istream cin;
+
+string input(const char* prompt = "") {
+    if(strlen_simple(prompt) > 0) {
+        raz::cout << prompt;
+    }
+    string result;
+    raz::cin.getline(result);
+    return result;
+}
+
+template<typename T>
+T input_as(const char* prompt = "") {
+    if(strlen_simple(prompt) > 0) {
+        raz::cout << prompt;
+    }
+    T result;
+    raz::cin >> result;
     return result;
 }
 
-template<typename K, typename V>
-class map {
-private:
-    pair<K, V>* data;
-    u32 len;
-    u32 cap;
+struct map_options {
+    bool sequential = true;   // MADV_SEQUENTIAL: aggressive readahead, early reclaim
+    bool will_need = true;    // MADV_WILLNEED: start reading the whole file now
+    bool huge_pages = false;  // MADV_HUGEPAGE where the filesystem supports it
+    bool populate = false;    // MAP_POPULATE: fault every page in before returning
+};
+
+// Read-only view of a whole file through mmap. Nothing is copied: data(),
+// the byte span and every line or record view point into the mapping, so they
+// are valid until the mapped_file is closed or destroyed.
+class mapped_file {
+private:
+    char* ptr;
+    u64 len;
+    bool opened;
+
+public:
+    mapped_file() : ptr(nullptr), len(0), opened(false) {}
+
+    explicit mapped_file(const char* path, const map_options& options = map_options())
+        : ptr(nullptr), len(0), opened(false) {
+        open(path, options);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& other) : ptr(other.ptr), len(other.len), opened(other.opened) {
+        other.ptr = nullptr;
+        other.len = 0;
+        other.opened = false;
+    }
+
+    mapped_file& operator=(mapped_file&& other) {
+        if(this != &other) {
+            close();
+            ptr = other.ptr;
+            len = other.len;
+            opened = other.opened;
+            other.ptr = nullptr;
+            other.len = 0;
+            other.opened = false;
+        }
+        return *this;
+    }
+
+    ~mapped_file() { close(); }
+
+    // Maps the file; an empty file opens successfully with no data.
+    bool open(const char* path, const map_options& options = map_options()) {
+        close();
+        i32 fd = sys::open(path, sys::o_rdonly);
+        if(fd < 0) return false;
+        long size = sys::lseek(fd, 0, sys::seek_end);
+        if(size < 0) {
+            sys::close(fd);
+            return false;
+        }
+        if(size > 0) {
+            i32 flags = sys::map_private | (options.populate ? sys::map_populate : 0);
+            void* mem = sys::mmap(nullptr, (u64)size, sys::prot_read, flags, fd, 0);
+            if(!mem) {
+                sys::close(fd);
+                return false;
+            }
+            ptr = (char*)mem;
+            len = (u64)size;
+            if(options.huge_pages) sys::madvise(ptr, len, sys::madv_hugepage);
+            if(options.sequential) sys::madvise(ptr, len, sys::madv_sequential);
+            if(options.will_need) sys::madvise(ptr, len, sys::madv_willneed);
+        }
+        sys::close(fd);
+        opened = true;
+        return true;
+    }
+
+    void close() {
+        if(ptr) sys::munmap(ptr, len);
+        ptr = nullptr;
+        len = 0;
+        opened = false;
+    }
+
+    bool is_open() const { return opened; }
+    explicit operator bool() const { return opened; }
+
+    const char* data() const { return ptr; }
+    u64 size() const { return len; }
+    bool empty() const { return len == 0; }
+    const char* begin() const { return ptr; }
+    const char* end() const { return ptr + len; }
+    char operator[](u64 index) const { return ptr[index]; }
+
+    // A window of at most 4GB (string_view lengths are u32).
+    string_view view(u64 offset = 0, u32 count = 0xFFFFFFFFu) const {
+        if(offset >= len) return string_view();
+        u64 left = len - offset;
+        return string_view(ptr + offset, left < count ? (u32)left : count);
+    }
+
+    // Lines without their '\n' or "\r\n", as views into the mapping.
+    split_range lines() const { return split_range(begin(), end(), '\n', true); }
+    split_range records(char delim) const { return split_range(begin(), end(), delim, false); }
+};
+
+template<typename K, typename V, typename A = heap_allocator>
+class map {
+private:
+    pair<K, V>* data;
+    u32 len;
+    u32 cap;
+    [[no_unique_address]] A alloc;
+
+    void resize(u32 new_cap) {
+        pair<K, V>* new_data = (pair<K, V>*)alloc.allocate(sizeof(pair<K, V>) * new_cap);
+        RAZ_STAT(stats.maps.record_alloc(sizeof(pair<K, V>) * new_cap, new_cap));
+        RAZ_STAT(stats.maps.record_growth());
+        for(u32 i = 0; i < len; i++) {
+            new (&new_data[i]) pair<K, V>(move(data[i]));
+            data[i].~pair<K, V>();
+        }
+        alloc.deallocate(data, sizeof(pair<K, V>) * cap);
+        data = new_data;
+        cap = new_cap;
+    }
+
+    i32 find_index(const K& key) const {
+        for(u32 i = 0; i < len; i++) {
+            if(data[i].first == key) {
+                RAZ_STAT(stats.maps.record_scan(i + 1));
+                return (i32)i;
+            }
+        }
+        RAZ_STAT(stats.maps.record_scan(len));
+        return -1;
+    }
+
+public:
+    map(const A& a = A()) : len(0), cap(8), alloc(a) {
+        data = (pair<K, V>*)alloc.allocate(sizeof(pair<K, V>) * cap);
+        RAZ_STAT(stats.maps.record_alloc(sizeof(pair<K, V>) * cap, cap));
+    }
+
+    map(const map& other) : len(0), cap(other.cap), alloc(other.alloc) {
+        RAZ_STAT(stats.maps.record_copy());
+        data = (pair<K, V>*)alloc.allocate(sizeof(pair<K, V>) * cap);
+        RAZ_STAT(stats.maps.record_alloc(sizeof(pair<K, V>) * cap, cap));
+        for(; len < other.len; len++) new (&data[len]) pair<K, V>(other.data[len]);
+    }
+
+    map& operator=(const map& other) {
+        if(this != &other) {
+            RAZ_STAT(stats.maps.record_copy());
+            clear();
+            if(other.len > cap) resize(other.cap);
+            for(; len < other.len; len++) new (&data[len]) pair<K, V>(other.data[len]);
+        }
+        return *this;
+    }
+
+    ~map() {
+        clear();
+        alloc.deallocate(data, sizeof(pair<K, V>) * cap);
+    }
+
+    void insert(const K& key, const V& value) {
+        i32 idx = find_index(key);
+        if(idx >= 0) {
+            data[idx].second = value;
+            return;
+        }
+
+        if(len >= cap) resize(cap * 2);
+        new (&data[len++]) pair<K, V>(key, value);
+    }
+
+    optional<V> get(const K& key) const {
+        i32 idx = find_index(key);
+        if(idx < 0) return optional<V>();
+        return optional<V>(data[idx].second);
+    }
+
+    bool contains(const K& key) const {
+        return find_index(key) >= 0;
+    }
+
+    u32 size() const { return len; }
+    bool empty() const { return len == 0; }
+
+    void clear() {
+        for(u32 i = 0; i < len; i++) data[i].~pair<K, V>();
+        len = 0;
+    }
+
+    void erase(const K& key) {
+        i32 idx = find_index(key);
+        if(idx < 0) return;
+        for(u32 j = (u32)idx; j < len - 1; j++) {
+            data[j] = move(data[j + 1]);
+        }
+        data[--len].~pair<K, V>();
+    }
+};
+
+namespace detail {
+
+static constexpr u64 wy_secret[4] = {
+    0x2D358DCCAA6C78A5ULL, 0x8BB84B93962EACC9ULL, 0x4B33A62ED433D4A3ULL, 0x4D5A2DA51DE1AA47ULL
+};
+
+inline u64 wy_mix(u64 a, u64 b) {
+    u64 hi;
+    u64 lo = mul_128(a, b, hi);
+    return lo ^ hi;
+}
+
+inline u64 load_u32_le(const u8* p) {
+    u32 v;
+    memcpy_simple(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+inline u64 load_u64_le(const u8* p) { return load_u64_le((const char*)p); }
+
+inline u64 make_hash_seed() {
+#ifdef RAZ_HASH_SEED
+    return RAZ_HASH_SEED;
+#else
+    u64 seed = 0;
+    if(sys::getrandom(&seed, sizeof(seed)) != (long)sizeof(seed)) {
+        // No entropy source: fall back to ASLR-dependent addresses.
+        seed = (u64)&seed ^ ((u64)&make_hash_seed << 17);
+    }
+    return wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+#endif
+}
+
+}
+
+// Per-process seed used by raz::hash. Define RAZ_HASH_SEED for reproducible
+// runs; pass an explicit seed to hash_bytes for hashes that are persisted.
+static const u64 hash_seed = detail::make_hash_seed();
+
+// wyhash (final version 4): 48 bytes per step on long inputs, at most two
+// overlapping reads on short ones.
+u64 hash_bytes(const void* ptr, u64 len, u64 seed = 0) {
+    using namespace detail;
+    const u8* p = (const u8*)ptr;
+    seed ^= wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+    u64 a, b;
+    if(len <= 16) {
+        if(len >= 4) {
+            u64 shift = (len >> 3) << 2;
+            a = (load_u32_le(p) << 32) | load_u32_le(p + shift);
+            b = (load_u32_le(p + len - 4) << 32) | load_u32_le(p + len - 4 - shift);
+        } else if(len > 0) {
+            a = ((u64)p[0] << 16) | ((u64)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        u64 i = len;
+        if(i > 48) {
+            u64 see1 = seed, see2 = seed;
+            do {
+                seed = wy_mix(load_u64_le(p) ^ wy_secret[1], load_u64_le(p + 8) ^ seed);
+                see1 = wy_mix(load_u64_le(p + 16) ^ wy_secret[2], load_u64_le(p + 24) ^ see1);
+                see2 = wy_mix(load_u64_le(p + 32) ^ wy_secret[3], load_u64_le(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while(i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16) {
+            seed = wy_mix(load_u64_le(p) ^ wy_secret[1], load_u64_le(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = load_u64_le(p + i - 16);
+        b = load_u64_le(p + i - 8);
+    }
+    a ^= wy_secret[1];
+    b ^= seed;
+    a = mul_128(a, b, b);
+    return wy_mix(a ^ wy_secret[0] ^ len, b ^ wy_secret[1]);
+}
+
+// Single-word hash, much cheaper than hash_bytes on eight bytes.
+u64 hash_u64(u64 value, u64 seed = 0) {
+    return detail::wy_mix(value ^ seed ^ detail::wy_secret[0], detail::wy_secret[1]);
+}
+
+u64 hash_combine(u64 h1, u64 h2) {
+    return detail::wy_mix(h1 ^ detail::wy_secret[2], h2 ^ detail::wy_secret[3]);
+}
+
+// Customization point: specialize for your own key types. Integers, enums and
+// bools use the primary template.
+template<typename T>
+struct hash {
+    u64 operator()(const T& value) const { return hash_u64((u64)value, hash_seed); }
+};
+
+template<typename T>
+struct hash<T*> {
+    u64 operator()(T* value) const { return hash_u64((u64)value, hash_seed); }
+};
+
+template<>
+struct hash<f64> {
+    u64 operator()(f64 value) const {
+        if(value == 0.0) value = 0.0;
+        u64 bits;
+        memcpy_simple(&bits, &value, sizeof(bits));
+        return hash_u64(bits, hash_seed);
+    }
+};
+
+template<>
+struct hash<f32> {
+    u64 operator()(f32 value) const {
+        if(value == 0.0f) value = 0.0f;
+        u32 bits;
+        memcpy_simple(&bits, &value, sizeof(bits));
+        return hash_u64(bits, hash_seed);
+    }
+};
+
+template<typename A>
+struct hash<basic_string<A>> {
+    u64 operator()(const basic_string<A>& value) const { return hash_bytes(value.c_str(), value.length(), hash_seed); }
+    u64 operator()(const char* value) const { return hash_bytes(value, strlen_simple(value), hash_seed); }
+    u64 operator()(string_view value) const { return hash_bytes(value.data(), value.length(), hash_seed); }
+};
+
+template<>
+struct hash<string_view> {
+    u64 operator()(string_view value) const { return hash_bytes(value.data(), value.length(), hash_seed); }
+};
+
+template<typename K, typename V>
+struct hash<pair<K, V>> {
+    u64 operator()(const pair<K, V>& value) const {
+        return hash_combine(hash<K>()(value.first), hash<V>()(value.second));
+    }
+};
+
+template<typename K, typename V, typename H = hash<K>, typename A = heap_allocator>
+class hash_map {
+private:
+    pair<K, V>* slots;
+    u32* dist;
+    u32 len;
+    u32 cap;
+    [[no_unique_address]] A alloc;
+
+    static constexpr u32 min_cap = 8;
+
+    u32 home(u64 h) const {
+        return (u32)((h * 0x9E3779B97F4A7C15ULL) >> 32) & (cap - 1);
+    }
+
+    template<typename Q>
+    i32 find_index(const Q& key) const {
+        if(len == 0) return -1;
+        u32 i = home(H()(key));
+        for(u32 d = 1; dist[i] >= d; d++) {
+            if(dist[i] == d && slots[i].first == key) {
+                RAZ_STAT(stats.hash_maps.record_scan(d));
+                return (i32)i;
+            }
+            i = (i + 1) & (cap - 1);
+        }
+        RAZ_STAT(stats.hash_maps.record_scan(dist[i] + 1));
+        return -1;
+    }
+
+    void place(pair<K, V>& item) {
+        u32 i = home(H()(item.first));
+        u32 d = 1;
+        while(true) {
+            if(dist[i] == 0) {
+                new (&slots[i]) pair<K, V>(move(item));
+                dist[i] = d;
+                len++;
+                return;
+            }
+            if(dist[i] < d) {
+                swap(slots[i], item);
+                swap(dist[i], d);
+            }
+            i = (i + 1) & (cap - 1);
+            d++;
+        }
+    }
+
+    void rehash(u32 new_cap) {
+        RAZ_STAT(stats.hash_maps.record_growth());
+        pair<K, V>* old_slots = slots;
+        u32* old_dist = dist;
+        u32 old_cap = cap;
+
+        init(new_cap);
+        for(u32 i = 0; i < old_cap; i++) {
+            if(old_dist[i] == 0) continue;
+            pair<K, V> item(move(old_slots[i]));
+            old_slots[i].~pair<K, V>();
+            place(item);
+        }
+        alloc.deallocate(old_slots, sizeof(pair<K, V>) * old_cap);
+        alloc.deallocate(old_dist, sizeof(u32) * old_cap);
+    }
+
+    void destroy_slots() {
+        for(u32 i = 0; i < cap; i++) {
+            if(dist[i] != 0) slots[i].~pair<K, V>();
+        }
+        alloc.deallocate(slots, sizeof(pair<K, V>) * cap);
+        alloc.deallocate(dist, sizeof(u32) * cap);
+    }
+
+    void init(u32 new_cap) {
+        slots = (pair<K, V>*)alloc.allocate(sizeof(pair<K, V>) * new_cap);
+        dist = (u32*)alloc.allocate(sizeof(u32) * new_cap);
+        RAZ_STAT(stats.hash_maps.record_alloc((sizeof(pair<K, V>) + sizeof(u32)) * new_cap, new_cap));
+        for(u32 i = 0; i < new_cap; i++) dist[i] = 0;
+        len = 0;
+        cap = new_cap;
+    }
+
+    static u32 cap_for(u32 count) {
+        u32 c = min_cap;
+        while(c - c / 8 < count) c *= 2;
+        return c;
+    }
+
+public:
+    hash_map(const A& a = A()) : alloc(a) { init(min_cap); }
+
+    hash_map(const hash_map& other) : alloc(other.alloc) {
+        RAZ_STAT(stats.hash_maps.record_copy());
+        init(other.cap);
+        for(u32 i = 0; i < other.cap; i++) {
+            if(other.dist[i] != 0) insert(other.slots[i].first, other.slots[i].second);
+        }
+    }
+
+    hash_map& operator=(const hash_map& other) {
+        if(this != &other) {
+            RAZ_STAT(stats.hash_maps.record_copy());
+            destroy_slots();
+            init(other.cap);
+            for(u32 i = 0; i < other.cap; i++) {
+                if(other.dist[i] != 0) insert(other.slots[i].first, other.slots[i].second);
+            }
+        }
+        return *this;
+    }
+
+    ~hash_map() {
+        destroy_slots();
+    }
+
+    void reserve(u32 count) {
+        u32 new_cap = cap_for(count);
+        if(new_cap > cap) rehash(new_cap);
+    }
+
+    void insert(const K& key, const V& value) {
+        i32 idx = find_index(key);
+        if(idx >= 0) {
+            slots[idx].second = value;
+            return;
+        }
+        if(len + 1 > cap - cap / 8) rehash(cap * 2);
+        pair<K, V> item(key, value);
+        place(item);
+    }
+
+    template<typename Q>
+    V* find(const Q& key) {
+        i32 idx = find_index(key);
+        return idx >= 0 ? &slots[idx].second : nullptr;
+    }
+
+    template<typename Q>
+    const V* find(const Q& key) const {
+        i32 idx = find_index(key);
+        return idx >= 0 ? &slots[idx].second : nullptr;
+    }
+
+    template<typename Q>
+    optional<V> get(const Q& key) const {
+        i32 idx = find_index(key);
+        if(idx < 0) return optional<V>();
+        return optional<V>(slots[idx].second);
+    }
+
+    template<typename Q>
+    bool contains(const Q& key) const {
+        return find_index(key) >= 0;
+    }
+
+    template<typename Q>
+    bool erase(const Q& key) {
+        i32 found = find_index(key);
+        if(found < 0) return false;
+
+        u32 i = (u32)found;
+        slots[i].~pair<K, V>();
+        u32 next = (i + 1) & (cap - 1);
+        while(dist[next] > 1) {
+            new (&slots[i]) pair<K, V>(move(slots[next]));
+            slots[next].~pair<K, V>();
+            dist[i] = dist[next] - 1;
+            i = next;
+            next = (next + 1) & (cap - 1);
+        }
+        dist[i] = 0;
+        len--;
+        return true;
+    }
+
+    void clear() {
+        for(u32 i = 0; i < cap; i++) {
+            if(dist[i] != 0) {
+                slots[i].~pair<K, V>();
+                dist[i] = 0;
+            }
+        }
+        len = 0;
+    }
+
+    template<typename F>
+    void for_each(F fn) const {
+        for(u32 i = 0; i < cap; i++) {
+            if(dist[i] != 0) fn(slots[i].first, slots[i].second);
+        }
+    }
+
+    u32 size() const { return len; }
+    u32 capacity() const { return cap; }
+    bool empty() const { return len == 0; }
+};
+
+namespace detail {
+
+// Little-endian load of 4 or 8 bytes; byte by byte when constant evaluated.
+template<bool Constant>
+constexpr u64 frozen_word(const char* p, u32 n) {
+    if(!Constant) return n == 8 ? load_u64_le(p) : load_u32_le((const u8*)p);
+    u64 w = 0;
+    for(u32 i = 0; i < n; i++) w |= (u64)(u8)p[i] << (i * 8);
+    return w;
+}
+
+// Key hash that also runs at compile time: one multiply per 8 bytes and a
+// murmur finalizer; a 1..7 byte tail is read with at most two fixed-size loads.
+// Only used on the fixed key set, so no flooding concerns.
+template<bool Constant>
+constexpr u64 frozen_hash_with(const char* p, u32 len, u64 seed) {
+    u64 h = seed ^ ((u64)len * 0x9E3779B97F4A7C15ULL);
+    u32 i = 0;
+    for(; i + 8 <= len; i += 8) {
+        h = (h ^ frozen_word<Constant>(p + i, 8)) * 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 32;
+    }
+    u32 n = len - i;
+    if(n >= 4) {
+        h ^= (frozen_word<Constant>(p + i, 4) << 32) | frozen_word<Constant>(p + len - 4, 4);
+    } else if(n > 0) {
+        h ^= ((u64)(u8)p[i] << 16) | ((u64)(u8)p[i + (n >> 1)] << 8) | (u8)p[len - 1];
+    }
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Kept out of line so word loads from short literal keys do not trip
+// -Warray-bounds on paths the key length rules out.
+__attribute__((noinline)) inline u64 frozen_hash_runtime(const char* p, u32 len, u64 seed) {
+    return frozen_hash_with<false>(p, len, seed);
+}
+
+constexpr u64 frozen_hash(string_view key, u64 seed) {
+    if(__builtin_is_constant_evaluated()) return frozen_hash_with<true>(key.data(), key.length(), seed);
+    return frozen_hash_runtime(key.data(), key.length(), seed);
+}
+
+constexpr bool frozen_equal(string_view a, string_view b) {
+    if(!__builtin_is_constant_evaluated()) return a == b;
+    if(a.length() != b.length()) return false;
+    for(u32 i = 0; i < a.length(); i++) {
+        if(a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+constexpr u32 frozen_slot_count(u32 keys) {
+    u32 n = 2;
+    while(n < keys + keys / 4) n *= 2;
+    return n;
+}
+
+// Not constexpr on purpose: reaching one while building a constexpr
+// frozen_map turns the problem into a compile error naming it. A map built
+// at runtime traps instead of being silently broken.
+inline void frozen_map_duplicate_key() { __builtin_trap(); }
+inline void frozen_map_no_perfect_hash() { __builtin_trap(); }
+
+}
+
+// Read-only string-keyed map whose key set is fixed when it is built, usually
+// at compile time. A hash-and-displace perfect hash (one displacement per
+// bucket of about two keys) sends every key to its own slot, so a lookup is
+// one key hash, one displacement mix and one string compare. Entries keep
+// their declaration order; build with make_frozen_map.
+template<typename V, u32 N>
+class frozen_map {
+private:
+    static_assert(N > 0, "frozen_map needs at least one key");
+
+    static constexpr u32 slot_count = detail::frozen_slot_count(N);
+    static constexpr u32 bucket_count = N / 2 + 1;
+    static constexpr u32 max_pilot = 1u << 16;
+    static constexpr u32 max_seeds = 64;
+
+    pair<string_view, V> entries[N];
+    u32 pilots[bucket_count];
+    u32 slots[slot_count];
+    u64 seed;
+
+    static constexpr u32 bucket_of(u64 h) {
+        return (u32)(((h >> 32) * bucket_count) >> 32);
+    }
+
+    static constexpr u32 slot_of(u64 h, u32 pilot) {
+        u64 x = (h ^ ((u64)pilot * 0x9E3779B97F4A7C15ULL)) * 0xD6E8FEB86659FD93ULL;
+        return (u32)(x >> 32) & (slot_count - 1);
+    }
+
+    // Places the largest buckets first, each with the smallest displacement
+    // that lands all of its keys on free, distinct slots.
+    constexpr bool build(u64 try_seed) {
+        u64 hashes[N] = {};
+        u32 starts[bucket_count + 1] = {};
+        u32 fill[bucket_count] = {};
+        u32 members[N] = {};
+
+        for(u32 i = 0; i < N; i++) {
+            hashes[i] = detail::frozen_hash(entries[i].first, try_seed);
+            starts[bucket_of(hashes[i]) + 1]++;
+        }
+        u32 largest = 0;
+        for(u32 b = 0; b < bucket_count; b++) {
+            if(starts[b + 1] > largest) largest = starts[b + 1];
+            starts[b + 1] += starts[b];
+        }
+        for(u32 i = 0; i < N; i++) {
+            u32 b = bucket_of(hashes[i]);
+            members[starts[b] + fill[b]++] = i;
+        }
+        for(u32 i = 0; i < slot_count; i++) slots[i] = N;
+
+        for(u32 want = largest; want > 0; want--) {
+            for(u32 b = 0; b < bucket_count; b++) {
+                u32 first = starts[b];
+                u32 last = starts[b + 1];
+                if(last - first != want) continue;
+
+                u32 pilot = 0;
+                for(; pilot < max_pilot; pilot++) {
+                    bool fits = true;
+                    for(u32 j = first; j < last && fits; j++) {
+                        u32 s = slot_of(hashes[members[j]], pilot);
+                        if(slots[s] != N) fits = false;
+                        for(u32 k = first; k < j && fits; k++) {
+                            if(slot_of(hashes[members[k]], pilot) == s) fits = false;
+                        }
+                    }
+                    if(fits) break;
+                }
+                if(pilot == max_pilot) {
+                    for(u32 j = first; j < last; j++) {
+                        for(u32 k = first; k < j; k++) {
+                            if(detail::frozen_equal(entries[members[j]].first, entries[members[k]].first)) {
+                                detail::frozen_map_duplicate_key();
+                            }
+                        }
+                    }
+                    return false;
+                }
+                pilots[b] = pilot;
+                for(u32 j = first; j < last; j++) slots[slot_of(hashes[members[j]], pilot)] = members[j];
+            }
+        }
+        seed = try_seed;
+        return true;
+    }
+
+public:
+    constexpr frozen_map(const pair<string_view, V> (&items)[N]) : entries(), pilots(), slots(), seed(0) {
+        for(u32 i = 0; i < N; i++) entries[i] = items[i];
+        u64 try_seed = 0;
+        while(!build(try_seed)) {
+            if(++try_seed == max_seeds) {
+                detail::frozen_map_no_perfect_hash();
+                break;
+            }
+        }
+    }
+
+    // Position of `key` in declaration order, -1 if it is not a key.
+    constexpr i32 index_of(string_view key) const {
+        u64 h = detail::frozen_hash(key, seed);
+        u32 idx = slots[slot_of(h, pilots[bucket_of(h)])];
+        return idx < N && detail::frozen_equal(entries[idx].first, key) ? (i32)idx : -1;
+    }
+
+    constexpr const V* find(string_view key) const {
+        i32 idx = index_of(key);
+        return idx >= 0 ? &entries[idx].second : nullptr;
+    }
+
+    optional<V> get(string_view key) const {
+        i32 idx = index_of(key);
+        if(idx < 0) return optional<V>();
+        return optional<V>(entries[idx].second);
+    }
+
+    constexpr bool contains(string_view key) const {
+        return index_of(key) >= 0;
+    }
+
+    template<typename F>
+    void for_each(F fn) const {
+        for(u32 i = 0; i < N; i++) fn(entries[i].first, entries[i].second);
+    }
+
+    constexpr u32 size() const { return N; }
+    constexpr bool empty() const { return false; }
+
+    constexpr const pair<string_view, V>* begin() const { return entries; }
+    constexpr const pair<string_view, V>* end() const { return entries + N; }
+};
+
+// constexpr auto commands = make_frozen_map<i32>({{"add", 1}, {"list", 2}});
+template<typename V, u32 N>
+constexpr frozen_map<V, N> make_frozen_map(const pair<string_view, V> (&items)[N]) {
+    return frozen_map<V, N>(items);
+}
+
+template<typename T, typename A = heap_allocator>
+class array {
+private:
+    T* data;
+    u32 len;
+    [[no_unique_address]] A alloc;
+
+public:
+    array(u32 size, const A& a = A()) : len(size), alloc(a) {
+        data = (T*)alloc.allocate(sizeof(T) * len);
+        for(u32 i = 0; i < len; i++) new (&data[i]) T();
+    }
+    
+    array(std::initializer_list<T> init_list, const A& a = A()) : len(init_list.size()), alloc(a) {
+        data = (T*)alloc.allocate(sizeof(T) * len);
+        u32 i = 0;
+        for(const T& item : init_list) {
+            new (&data[i++]) T(item);
+        }
+    }
+
+    array(const array& other) : len(other.len), alloc(other.alloc) {
+        data = (T*)alloc.allocate(sizeof(T) * len);
+        for(u32 i = 0; i < len; i++) new (&data[i]) T(other.data[i]);
+    }
+
+    array& operator=(const array&) = delete;
+
+    ~array() {
+        for(u32 i = 0; i < len; i++) data[i].~T();
+        alloc.deallocate(data, sizeof(T) * len);
+    }
+
+    T& operator[](u32 index) { return data[index]; }
+    const T& operator[](u32 index) const { return data[index]; }
+    
+    u32 size() const { return len; }
+    T* begin() { return data; }
+    T* end() { return data + len; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + len; }
+};
+
+template<typename T, typename A = heap_allocator>
+class vector {
+private:
+    T* data;
+    u32 len;
+    u32 cap;
+    [[no_unique_address]] A alloc;
+
+    static constexpr u32 min_cap = 8;
+
+    T* allocate(u32 count) {
+        if(!count) return nullptr;
+        RAZ_STAT(stats.vectors.record_alloc(sizeof(T) * count, count));
+        return (T*)alloc.allocate(sizeof(T) * count);
+    }
+
+    void deallocate(T* ptr, u32 count) {
+        if(ptr) alloc.deallocate(ptr, sizeof(T) * count);
+    }
+
+    static void relocate(T* dest, T* src, u32 count) {
+        if(is_trivially_copyable<T>::value) {
+            if(count) memcpy_simple((void*)dest, (const void*)src, sizeof(T) * count);
+            return;
+        }
+        for(u32 i = 0; i < count; i++) {
+            new (&dest[i]) T(move(src[i]));
+            src[i].~T();
+        }
+    }
+
+    void destroy_range(u32 from, u32 to) {
+        if(is_trivially_copyable<T>::value) return;
+        for(u32 i = from; i < to; i++) data[i].~T();
+    }
+
+    void reallocate(u32 new_cap) {
+        RAZ_STAT(stats.vectors.record_growth());
+        T* new_data = allocate(new_cap);
+        relocate(new_data, data, len);
+        deallocate(data, cap);
+        data = new_data;
+        cap = new_cap;
+    }
+
+    u32 next_cap() const {
+        return cap ? cap * 2 : min_cap;
+    }
+
+    template<typename... Args>
+    T& grow_and_emplace(Args&&... args) {
+        RAZ_STAT(stats.vectors.record_growth());
+        u32 new_cap = next_cap();
+        T* new_data = allocate(new_cap);
+        new (&new_data[len]) T(forward<Args>(args)...);
+        relocate(new_data, data, len);
+        deallocate(data, cap);
+        data = new_data;
+        cap = new_cap;
+        return data[len++];
+    }
+
+public:
+    vector(const A& a = A()) : data(nullptr), len(0), cap(0), alloc(a) {}
+
+    vector(u32 size, const A& a = A()) : data(nullptr), len(size), cap(size), alloc(a) {
+        data = allocate(size);
+        for(u32 i = 0; i < len; i++) new (&data[i]) T();
+    }
+
+    vector(const vector& other) : data(nullptr), len(other.len), cap(other.len), alloc(other.alloc) {
+        RAZ_STAT(stats.vectors.record_copy());
+        data = allocate(len);
+        if(is_trivially_copyable<T>::value) {
+            if(len) memcpy_simple((void*)data, (const void*)other.data, sizeof(T) * len);
+            return;
+        }
+        for(u32 i = 0; i < len; i++) new (&data[i]) T(other.data[i]);
+    }
+
+    vector(vector&& other) : data(other.data), len(other.len), cap(other.cap), alloc(other.alloc) {
+        other.data = nullptr;
+        other.len = 0;
+        other.cap = 0;
+    }
+
+    vector(std::initializer_list<T> init_list, const A& a = A()) : data(nullptr), len(0), cap(init_list.size()), alloc(a) {
+        data = allocate(cap);
+        for(const T& item : init_list) {
+            new (&data[len++]) T(item);
+        }
+    }
+
+    ~vector() {
+        destroy_range(0, len);
+        deallocate(data, cap);
+    }
+
+    vector& operator=(const vector& other) {
+        if(this != &other) {
+            RAZ_STAT(stats.vectors.record_copy());
+            clear();
+            reserve(other.len);
+            for(u32 i = 0; i < other.len; i++) new (&data[i]) T(other.data[i]);
+            len = other.len;
+        }
+        return *this;
+    }
+
+    vector& operator=(vector&& other) {
+        if(this != &other) {
+            destroy_range(0, len);
+            deallocate(data, cap);
+            alloc = other.alloc;
+            data = other.data;
+            len = other.len;
+            cap = other.cap;
+            other.data = nullptr;
+            other.len = 0;
+            other.cap = 0;
+        }
+        return *this;
+    }
+
+    void reserve(u32 new_cap) {
+        if(new_cap > cap) reallocate(new_cap);
+    }
+
+    void shrink_to_fit() {
+        if(len < cap) reallocate(len);
+    }
+
+    void resize(u32 new_len) {
+        if(new_len > cap) reallocate(new_len > next_cap() ? new_len : next_cap());
+        for(u32 i = len; i < new_len; i++) new (&data[i]) T();
+        destroy_range(new_len, len);
+        len = new_len;
+    }
+
+    // `value` may live in this vector, so it is copied before reallocate() moves
+    // the elements out from under it.
+    void resize(u32 new_len, const T& value) {
+        if(new_len > cap) {
+            T item(value);
+            reallocate(new_len > next_cap() ? new_len : next_cap());
+            for(u32 i = len; i < new_len; i++) new (&data[i]) T(item);
+            len = new_len;
+            return;
+        }
+        for(u32 i = len; i < new_len; i++) new (&data[i]) T(value);
+        destroy_range(new_len, len);
+        len = new_len;
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if(len >= cap) return grow_and_emplace(forward<Args>(args)...);
+        new (&data[len]) T(forward<Args>(args)...);
+        return data[len++];
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(move(value)); }
+
+    void pop_back() {
+        if(len > 0) {
+            len--;
+            destroy_range(len, len + 1);
+        }
+    }
+
+    T& operator[](u32 index) { return data[index]; }
+    const T& operator[](u32 index) const { return data[index]; }
+
+    u32 size() const { return len; }
+    u32 capacity() const { return cap; }
+    bool empty() const { return len == 0; }
+
+    T* begin() { return data; }
+    T* end() { return data + len; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + len; }
+
+    void clear() {
+        destroy_range(0, len);
+        len = 0;
+    }
+    
+    T& front() { return data[0]; }
+    T& back() { return data[len - 1]; }
+    const T& front() const { return data[0]; }
+    const T& back() const { return data[len - 1]; }
+};
+namespace detail {
+
+// Trivial element types live in a real array so that static_vector stays a
+// literal type; everything else gets raw aligned bytes, constructed in place
+// and destroyed here.
+template<typename T, u32 N, bool = is_trivial<T>::value>
+struct static_vector_storage {
+    T items[N];
+    u32 len;
+
+    constexpr static_vector_storage() : items(), len(0) {}
+    constexpr T* ptr() { return items; }
+    constexpr const T* ptr() const { return items; }
+};
+
+template<typename T, u32 N>
+struct static_vector_storage<T, N, false> {
+    alignas(T) byte bytes[sizeof(T) * N];
+    u32 len;
+
+    static_vector_storage() : len(0) {}
+    static_vector_storage(const static_vector_storage&) = delete;
+    ~static_vector_storage() {
+        for(u32 i = 0; i < len; i++) ptr()[i].~T();
+    }
+
+    T* ptr() { return (T*)bytes; }
+    const T* ptr() const { return (const T*)bytes; }
+};
+
+}
+
+// vector with a fixed capacity of N held inline: never allocates, and for
+// trivial T it can be built and used in constant expressions. Growing past N
+// traps.
+template<typename T, u32 N>
+class static_vector {
+private:
+    static_assert(N > 0, "static_vector needs a capacity");
+
+    detail::static_vector_storage<T, N> storage;
+
+    static constexpr bool trivial = is_trivial<T>::value;
+
+    template<typename... Args>
+    constexpr void construct(u32 index, Args&&... args) {
+        if constexpr(trivial) {
+            storage.ptr()[index] = T(forward<Args>(args)...);
+        } else {
+            new (&storage.ptr()[index]) T(forward<Args>(args)...);
+        }
+    }
+
+    constexpr void destroy_range(u32 from, u32 to) {
+        if constexpr(!trivial) {
+            for(u32 i = from; i < to; i++) storage.ptr()[i].~T();
+        }
+    }
+
+    static constexpr void check(u32 count) {
+        if(count > N) __builtin_trap();
+    }
+
+    constexpr void copy_from(const static_vector& other) {
+        for(u32 i = 0; i < other.size(); i++) construct(i, other[i]);
+        storage.len = other.size();
+    }
+
+    constexpr void move_from(static_vector& other) {
+        for(u32 i = 0; i < other.size(); i++) construct(i, move(other[i]));
+        storage.len = other.size();
+        other.clear();
+    }
+
+public:
+    constexpr static_vector() : storage() {}
+
+    constexpr static_vector(u32 size) : storage() {
+        check(size);
+        for(; storage.len < size; storage.len++) construct(storage.len);
+    }
+
+    constexpr static_vector(std::initializer_list<T> init_list) : storage() {
+        check((u32)init_list.size());
+        for(const T& item : init_list) construct(storage.len++, item);
+    }
+
+    constexpr static_vector(const static_vector& other) : storage() { copy_from(other); }
+    constexpr static_vector(static_vector&& other) : storage() { move_from(other); }
+
+    constexpr static_vector& operator=(const static_vector& other) {
+        if(this != &other) {
+            clear();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    constexpr static_vector& operator=(static_vector&& other) {
+        if(this != &other) {
+            clear();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    // Capacity is fixed; these exist so code written against vector compiles.
+    constexpr void reserve(u32 new_cap) { check(new_cap); }
+    constexpr void shrink_to_fit() {}
+
+    constexpr void resize(u32 new_len) {
+        check(new_len);
+        for(u32 i = storage.len; i < new_len; i++) construct(i);
+        destroy_range(new_len, storage.len);
+        storage.len = new_len;
+    }
+
+    constexpr void resize(u32 new_len, const T& value) {
+        check(new_len);
+        for(u32 i = storage.len; i < new_len; i++) construct(i, value);
+        destroy_range(new_len, storage.len);
+        storage.len = new_len;
+    }
+
+    template<typename... Args>
+    constexpr T& emplace_back(Args&&... args) {
+        check(storage.len + 1);
+        construct(storage.len, forward<Args>(args)...);
+        return storage.ptr()[storage.len++];
+    }
+
+    constexpr void push_back(const T& value) { emplace_back(value); }
+    constexpr void push_back(T&& value) { emplace_back(move(value)); }
+
+    constexpr void pop_back() {
+        if(storage.len > 0) {
+            storage.len--;
+            destroy_range(storage.len, storage.len + 1);
+        }
+    }
+
+    constexpr T& operator[](u32 index) { return storage.ptr()[index]; }
+    constexpr const T& operator[](u32 index) const { return storage.ptr()[index]; }
+
+    constexpr u32 size() const { return storage.len; }
+    constexpr u32 capacity() const { return N; }
+    constexpr bool empty() const { return storage.len == 0; }
+    constexpr bool full() const { return storage.len == N; }
+
+    constexpr T* begin() { return storage.ptr(); }
+    constexpr T* end() { return storage.ptr() + storage.len; }
+    constexpr const T* begin() const { return storage.ptr(); }
+    constexpr const T* end() const { return storage.ptr() + storage.len; }
+
+    constexpr void clear() {
+        destroy_range(0, storage.len);
+        storage.len = 0;
+    }
+
+    constexpr T& front() { return storage.ptr()[0]; }
+    constexpr T& back() { return storage.ptr()[storage.len - 1]; }
+    constexpr const T& front() const { return storage.ptr()[0]; }
+    constexpr const T& back() const { return storage.ptr()[storage.len - 1]; }
+};
+
+// vector that keeps up to N elements inline and only moves to the allocator
+// once it outgrows them. Moving an inline small_vector moves its elements.
+template<typename T, u32 N, typename A = heap_allocator>
+class small_vector {
+private:
+    static_assert(N > 0, "small_vector needs an inline capacity");
+
+    T* data;
+    u32 len;
+    u32 cap;
+    [[no_unique_address]] A alloc;
+    alignas(T) byte local_bytes[sizeof(T) * N];
+
+    T* local() { return (T*)local_bytes; }
+    bool is_inline() const { return data == (const T*)local_bytes; }
+
+    static void relocate(T* dest, T* src, u32 count) {
+        if(is_trivially_copyable<T>::value) {
+            if(count) memcpy_simple((void*)dest, (const void*)src, sizeof(T) * count);
+            return;
+        }
+        for(u32 i = 0; i < count; i++) {
+            new (&dest[i]) T(move(src[i]));
+            src[i].~T();
+        }
+    }
+
+    void destroy_range(u32 from, u32 to) {
+        if(is_trivially_copyable<T>::value) return;
+        for(u32 i = from; i < to; i++) data[i].~T();
+    }
+
+    void release() {
+        if(!is_inline()) alloc.deallocate(data, sizeof(T) * cap);
+        data = local();
+        cap = N;
+    }
+
+    // Moves the elements to a buffer of `new_cap`, which is the inline one when
+    // they fit.
+    void reallocate(u32 new_cap) {
+        RAZ_STAT(stats.vectors.record_growth());
+        T* new_data = local();
+        if(new_cap > N) {
+            RAZ_STAT(stats.vectors.record_alloc(sizeof(T) * new_cap, new_cap));
+            new_data = (T*)alloc.allocate(sizeof(T) * new_cap);
+        } else {
+            new_cap = N;
+        }
+        if(new_data == data) return;
+        relocate(new_data, data, len);
+        if(!is_inline()) alloc.deallocate(data, sizeof(T) * cap);
+        data = new_data;
+        cap = new_cap;
+    }
+
+    u32 next_cap() const {
+        return cap * 2;
+    }
+
+    template<typename... Args>
+    T& grow_and_emplace(Args&&... args) {
+        RAZ_STAT(stats.vectors.record_growth());
+        u32 new_cap = next_cap();
+        RAZ_STAT(stats.vectors.record_alloc(sizeof(T) * new_cap, new_cap));
+        T* new_data = (T*)alloc.allocate(sizeof(T) * new_cap);
+        new (&new_data[len]) T(forward<Args>(args)...);
+        relocate(new_data, data, len);
+        if(!is_inline()) alloc.deallocate(data, sizeof(T) * cap);
+        data = new_data;
+        cap = new_cap;
+        return data[len++];
+    }
+
+    // Takes other's elements; other is left empty and inline.
+    void steal(small_vector& other) {
+        if(other.is_inline()) {
+            relocate(data, other.data, other.len);
+        } else {
+            data = other.data;
+            cap = other.cap;
+            other.data = other.local();
+            other.cap = N;
+        }
+        len = other.len;
+        other.len = 0;
+    }
+
+public:
+    small_vector(const A& a = A()) : data(local()), len(0), cap(N), alloc(a) {}
+
+    small_vector(u32 size, const A& a = A()) : data(local()), len(0), cap(N), alloc(a) {
+        reserve(size);
+        for(; len < size; len++) new (&data[len]) T();
+    }
+
+    small_vector(const small_vector& other) : data(local()), len(0), cap(N), alloc(other.alloc) {
+        RAZ_STAT(stats.vectors.record_copy());
+        reserve(other.len);
+        if(is_trivially_copyable<T>::value) {
+            if(other.len) memcpy_simple((void*)data, (const void*)other.data, sizeof(T) * other.len);
+            len = other.len;
+            return;
+        }
+        for(; len < other.len; len++) new (&data[len]) T(other.data[len]);
+    }
+
+    small_vector(small_vector&& other) : data(local()), len(0), cap(N), alloc(other.alloc) {
+        steal(other);
+    }
+
+    small_vector(std::initializer_list<T> init_list, const A& a = A()) : data(local()), len(0), cap(N), alloc(a) {
+        reserve((u32)init_list.size());
+        for(const T& item : init_list) {
+            new (&data[len++]) T(item);
+        }
+    }
+
+    ~small_vector() {
+        destroy_range(0, len);
+        release();
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if(this != &other) {
+            RAZ_STAT(stats.vectors.record_copy());
+            clear();
+            reserve(other.len);
+            for(u32 i = 0; i < other.len; i++) new (&data[i]) T(other.data[i]);
+            len = other.len;
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) {
+        if(this != &other) {
+            clear();
+            release();
+            alloc = other.alloc;
+            steal(other);
+        }
+        return *this;
+    }
+
+    void reserve(u32 new_cap) {
+        if(new_cap > cap) reallocate(new_cap);
+    }
+
+    // Moves back inline when the elements fit again.
+    void shrink_to_fit() {
+        if(len < cap && !is_inline()) reallocate(len);
+    }
+
+    void resize(u32 new_len) {
+        if(new_len > cap) reallocate(new_len > next_cap() ? new_len : next_cap());
+        for(u32 i = len; i < new_len; i++) new (&data[i]) T();
+        destroy_range(new_len, len);
+        len = new_len;
+    }
+
+    // `value` may live in this small_vector, so it is copied before reallocate() moves
+    // the elements out from under it.
+    void resize(u32 new_len, const T& value) {
+        if(new_len > cap) {
+            T item(value);
+            reallocate(new_len > next_cap() ? new_len : next_cap());
+            for(u32 i = len; i < new_len; i++) new (&data[i]) T(item);
+            len = new_len;
+            return;
+        }
+        for(u32 i = len; i < new_len; i++) new (&data[i]) T(value);
+        destroy_range(new_len, len);
+        len = new_len;
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if(len >= cap) return grow_and_emplace(forward<Args>(args)...);
+        new (&data[len]) T(forward<Args>(args)...);
+        return data[len++];
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(move(value)); }
+
+    void pop_back() {
+        if(len > 0) {
+            len--;
+            destroy_range(len, len + 1);
+        }
+    }
+
+    T& operator[](u32 index) { return data[index]; }
+    const T& operator[](u32 index) const { return data[index]; }
+
+    u32 size() const { return len; }
+    u32 capacity() const { return cap; }
+    bool empty() const { return len == 0; }
+
+    // True while the elements are still in the inline buffer.
+    bool is_small() const { return is_inline(); }
+
+    T* begin() { return data; }
+    T* end() { return data + len; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + len; }
+
+    void clear() {
+        destroy_range(0, len);
+        len = 0;
+    }
+
+    T& front() { return data[0]; }
+    T& back() { return data[len - 1]; }
+    const T& front() const { return data[0]; }
+    const T& back() const { return data[len - 1]; }
+};
+
+namespace detail {
+
+enum class bit_op { and_, or_, xor_, and_not };
+
+template<bit_op Op>
+inline u64 bit_apply(u64 a, u64 b) {
+    if constexpr(Op == bit_op::and_) return a & b;
+    else if constexpr(Op == bit_op::or_) return a | b;
+    else if constexpr(Op == bit_op::xor_) return a ^ b;
+    else return a & ~b;
+}
+
+#if defined(RAZ_SIMD_AVX2)
+template<bit_op Op>
+inline __m256i bit_apply(__m256i a, __m256i b) {
+    if constexpr(Op == bit_op::and_) return _mm256_and_si256(a, b);
+    else if constexpr(Op == bit_op::or_) return _mm256_or_si256(a, b);
+    else if constexpr(Op == bit_op::xor_) return _mm256_xor_si256(a, b);
+    else return _mm256_andnot_si256(b, a);
+}
+#elif defined(RAZ_SIMD_SSE2)
+template<bit_op Op>
+inline __m128i bit_apply(__m128i a, __m128i b) {
+    if constexpr(Op == bit_op::and_) return _mm_and_si128(a, b);
+    else if constexpr(Op == bit_op::or_) return _mm_or_si128(a, b);
+    else if constexpr(Op == bit_op::xor_) return _mm_xor_si128(a, b);
+    else return _mm_andnot_si128(b, a);
+}
+#elif defined(RAZ_SIMD_NEON)
+template<bit_op Op>
+inline uint64x2_t bit_apply(uint64x2_t a, uint64x2_t b) {
+    if constexpr(Op == bit_op::and_) return vandq_u64(a, b);
+    else if constexpr(Op == bit_op::or_) return vorrq_u64(a, b);
+    else if constexpr(Op == bit_op::xor_) return veorq_u64(a, b);
+    else return vbicq_u64(a, b);
+}
+#endif
+
+// dst[i] = dst[i] op src[i] over whole words.
+template<bit_op Op>
+inline void bits_apply(u64* dst, const u64* src, u32 words) {
+    u32 i = 0;
+#if defined(RAZ_SIMD_AVX2)
+    for(; i + 4 <= words; i += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), bit_apply<Op>(a, b));
+    }
+#elif defined(RAZ_SIMD_SSE2)
+    for(; i + 2 <= words; i += 2) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), bit_apply<Op>(a, b));
+    }
+#elif defined(RAZ_SIMD_NEON)
+    for(; i + 2 <= words; i += 2) {
+        vst1q_u64(dst + i, bit_apply<Op>(vld1q_u64(dst + i), vld1q_u64(src + i)));
+    }
+#endif
+    for(; i < words; i++) dst[i] = bit_apply<Op>(dst[i], src[i]);
+}
+
+// Set bits in whole words: nibble lookup (AVX2), SWAR on 128-bit lanes (SSE2,
+// which has no popcnt), vcnt (NEON).
+inline u64 bits_count(const u64* w, u32 words) {
+    u64 total = 0;
+    u32 i = 0;
+#if defined(RAZ_SIMD_AVX2)
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    for(; i + 4 <= words; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(w + i));
+        __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low));
+        __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    alignas(32) u64 lanes[4];
+    _mm256_store_si256((__m256i*)lanes, acc);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(RAZ_SIMD_SSE2)
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0F);
+    __m128i acc = _mm_setzero_si128();
+    for(; i + 2 <= words; i += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(w + i));
+        v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi64(v, 1), m1));
+        v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi64(v, 2), m2));
+        v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi64(v, 4)), m4);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+    }
+    total = (u64)_mm_cvtsi128_si64(acc) + (u64)_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc));
+#elif defined(RAZ_SIMD_NEON)
+    for(; i + 2 <= words; i += 2) total += vaddlvq_u8(vcntq_u8(vld1q_u8((const u8*)(w + i))));
+#endif
+    for(; i < words; i++) total += (u64)__builtin_popcountll(w[i]);
+    return total;
+}
+
+// Position of the k-th (0-based) set bit of a word that has more than k.
+inline u32 select_in_word(u64 w, u32 k) {
+#if defined(__BMI2__) && defined(RAZ_SIMD_AVX2)
+    return (u32)__builtin_ctzll(_pdep_u64(1ULL << k, w));
+#else
+    for(; k > 0; k--) w &= w - 1;
+    return (u32)__builtin_ctzll(w);
+#endif
+}
+
+// First bit >= from in [0, bits) that is set, or clear when `flip` is all
+// ones; -1 if there is none. Runs of empty words are skipped a vector at a time.
+inline i32 bits_find(const u64* w, u32 bits, u32 from, u64 flip) {
+    if(from >= bits) return -1;
+    u32 words = (bits + 63) / 64;
+    u32 i = from / 64;
+    u64 cur = (w[i] ^ flip) & (~0ULL << (from % 64));
+    while(!cur) {
+        i++;
+#if defined(RAZ_SIMD_AVX2)
+        __m256i f = _mm256_set1_epi64x((i64)flip);
+        while(i + 4 <= words) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(w + i)), f);
+            if(!_mm256_testz_si256(v, v)) break;
+            i += 4;
+        }
+#endif
+        if(i >= words) return -1;
+        cur = w[i] ^ flip;
+    }
+    u32 pos = i * 64 + (u32)__builtin_ctzll(cur);
+    return pos < bits ? (i32)pos : -1;
+}
+
+// Set bits in [0, pos).
+inline u32 bits_rank(const u64* w, u32 pos) {
+    u32 n = (u32)bits_count(w, pos / 64);
+    if(pos % 64) n += (u32)__builtin_popcountll(w[pos / 64] & ((1ULL << (pos % 64)) - 1));
+    return n;
+}
+
+// Index of the k-th (0-based) set bit, -1 if fewer are set.
+inline i32 bits_select(const u64* w, u32 words, u32 k) {
+    for(u32 i = 0; i < words; i++) {
+        u32 n = (u32)__builtin_popcountll(w[i]);
+        if(k < n) return (i32)(i * 64 + select_in_word(w[i], k));
+        k -= n;
+    }
+    return -1;
+}
+
+}
+
+// Fixed-size set of N bits packed into 64-bit words (bits past N are always
+// zero). Single-bit access is constexpr; set operations, counting and
+// searching go through the word/SIMD kernels above.
+template<u32 N>
+class bitset {
+private:
+    static_assert(N > 0, "bitset needs at least one bit");
+
+    static constexpr u32 word_total = (N + 63) / 64;
+    static constexpr u64 tail_mask = N % 64 ? (1ULL << (N % 64)) - 1 : ~0ULL;
+
+    u64 data[word_total];
+
+public:
+    constexpr bitset() : data() {}
+
+    constexpr bitset(std::initializer_list<u32> positions) : data() {
+        for(u32 pos : positions) set(pos);
+    }
+
+    constexpr bool test(u32 pos) const { return (data[pos / 64] >> (pos % 64)) & 1; }
+    constexpr bool operator[](u32 pos) const { return test(pos); }
+
+    constexpr void set(u32 pos) { data[pos / 64] |= 1ULL << (pos % 64); }
+    constexpr void set(u32 pos, bool value) { value ? set(pos) : reset(pos); }
+    constexpr void reset(u32 pos) { data[pos / 64] &= ~(1ULL << (pos % 64)); }
+    constexpr void flip(u32 pos) { data[pos / 64] ^= 1ULL << (pos % 64); }
+
+    constexpr void set_all() {
+        for(u32 i = 0; i < word_total; i++) data[i] = ~0ULL;
+        data[word_total - 1] = tail_mask;
+    }
+
+    constexpr void clear() {
+        for(u32 i = 0; i < word_total; i++) data[i] = 0;
+    }
+
+    constexpr void flip_all() {
+        for(u32 i = 0; i < word_total; i++) data[i] = ~data[i];
+        data[word_total - 1] &= tail_mask;
+    }
+
+    u32 count() const { return (u32)detail::bits_count(data, word_total); }
+    bool any() const { return find_first() >= 0; }
+    bool none() const { return !any(); }
+    bool all() const { return count() == N; }
+
+    // First set (or clear) bit at or after `from`, -1 if none:
+    // for(i32 i = b.find_first(); i >= 0; i = b.find_next(i + 1))
+    i32 find_first() const { return detail::bits_find(data, N, 0, 0); }
+    i32 find_next(u32 from) const { return detail::bits_find(data, N, from, 0); }
+    i32 find_first_clear() const { return detail::bits_find(data, N, 0, ~0ULL); }
+    i32 find_next_clear(u32 from) const { return detail::bits_find(data, N, from, ~0ULL); }
+
+    template<typename F>
+    void for_each_set(F fn) const {
+        for(u32 i = 0; i < word_total; i++) {
+            for(u64 w = data[i]; w; w &= w - 1) fn(i * 64 + (u32)__builtin_ctzll(w));
+        }
+    }
+
+    // Set bits in [0, pos), and the position of the k-th (0-based) set bit.
+    u32 rank(u32 pos) const { return detail::bits_rank(data, pos); }
+    i32 select(u32 k) const { return detail::bits_select(data, word_total, k); }
+
+    bitset& operator&=(const bitset& other) { detail::bits_apply<detail::bit_op::and_>(data, other.data, word_total); return *this; }
+    bitset& operator|=(const bitset& other) { detail::bits_apply<detail::bit_op::or_>(data, other.data, word_total); return *this; }
+    bitset& operator^=(const bitset& other) { detail::bits_apply<detail::bit_op::xor_>(data, other.data, word_total); return *this; }
+
+    // Removes every bit set in `other` (this &= ~other).
+    bitset& and_not(const bitset& other) { detail::bits_apply<detail::bit_op::and_not>(data, other.data, word_total); return *this; }
+
+    friend bitset operator&(bitset a, const bitset& b) { return a &= b; }
+    friend bitset operator|(bitset a, const bitset& b) { return a |= b; }
+    friend bitset operator^(bitset a, const bitset& b) { return a ^= b; }
+
+    bool operator==(const bitset& other) const { return memeq_simple(data, other.data, sizeof(data)); }
+    bool operator!=(const bitset& other) const { return !(*this == other); }
+
+    constexpr u32 size() const { return N; }
+    constexpr u32 word_count() const { return word_total; }
+    constexpr u64* words() { return data; }
+    constexpr const u64* words() const { return data; }
+};
+
+// bitset whose size is chosen at run time and can grow. Binary operations
+// expect operands of the same size.
+template<typename A = heap_allocator>
+class dynamic_bitset {
+private:
+    u64* data;
+    u32 bits;
+    u32 cap;
+    [[no_unique_address]] A alloc;
+
+    static u32 words_for(u32 n) { return (n + 63) / 64; }
+
+    u32 word_total() const { return words_for(bits); }
+
+    // Clears the bits past `bits` in the last word so counts and compares
+    // can work on whole words.
+    void trim() {
+        if(bits % 64) data[bits / 64] &= (1ULL << (bits % 64)) - 1;
+    }
+
+    void reallocate(u32 new_cap) {
+        RAZ_STAT(stats.vectors.record_growth());
+        RAZ_STAT(stats.vectors.record_alloc(new_cap * 8, new_cap));
+        u64* new_data = (u64*)alloc.allocate((u64)new_cap * 8);
+        u32 used = word_total();
+        if(used) memcpy_simple(new_data, data, used * 8);
+        for(u32 i = used; i < new_cap; i++) new_data[i] = 0;
+        if(data) alloc.deallocate(data, (u64)cap * 8);
+        data = new_data;
+        cap = new_cap;
+    }
+
+public:
+    dynamic_bitset(const A& a = A()) : data(nullptr), bits(0), cap(0), alloc(a) {}
+
+    dynamic_bitset(u32 size, bool value = false, const A& a = A()) : data(nullptr), bits(0), cap(0), alloc(a) {
+        resize(size, value);
+    }
+
+    dynamic_bitset(const dynamic_bitset& other) : data(nullptr), bits(0), cap(0), alloc(other.alloc) {
+        RAZ_STAT(stats.vectors.record_copy());
+        if(other.bits) reallocate(other.word_total());
+        bits = other.bits;
+        if(bits) memcpy_simple(data, other.data, word_total() * 8);
+    }
+
+    dynamic_bitset(dynamic_bitset&& other) : data(other.data), bits(other.bits), cap(other.cap), alloc(other.alloc) {
+        other.data = nullptr;
+        other.bits = 0;
+        other.cap = 0;
+    }
+
+    ~dynamic_bitset() {
+        if(data) alloc.deallocate(data, (u64)cap * 8);
+    }
+
+    dynamic_bitset& operator=(const dynamic_bitset& other) {
+        if(this != &other) {
+            RAZ_STAT(stats.vectors.record_copy());
+            u32 words = other.word_total();
+            if(words > cap) reallocate(words);
+            if(words) memcpy_simple(data, other.data, words * 8);
+            for(u32 i = words; i < word_total(); i++) data[i] = 0;
+            bits = other.bits;
+        }
+        return *this;
+    }
+
+    dynamic_bitset& operator=(dynamic_bitset&& other) {
+        if(this != &other) {
+            if(data) alloc.deallocate(data, (u64)cap * 8);
+            alloc = other.alloc;
+            data = other.data;
+            bits = other.bits;
+            cap = other.cap;
+            other.data = nullptr;
+            other.bits = 0;
+            other.cap = 0;
+        }
+        return *this;
+    }
+
+    void reserve(u32 new_bits) {
+        if(words_for(new_bits) > cap) reallocate(words_for(new_bits));
+    }
+
+    // New bits take `value`; words past the size are kept zero.
+    void resize(u32 new_bits, bool value = false) {
+        u32 words = words_for(new_bits);
+        if(words > cap) reallocate(words > cap * 2 ? words : cap * 2);
+        if(new_bits > bits && value) {
+            u32 i = bits;
+            for(; i < new_bits && i % 64; i++) set(i);
+            for(; i + 64 <= new_bits; i += 64) data[i / 64] = ~0ULL;
+            for(; i < new_bits; i++) set(i);
+        }
+        u32 old_words = word_total();
+        bits = new_bits;
+        if(new_bits < old_words * 64) {
+            for(u32 i = words; i < old_words; i++) data[i] = 0;
+            trim();
+        }
+    }
+
+    void push_back(bool value) {
+        if(bits == cap * 64) reallocate(cap ? cap * 2 : 1);
+        set(bits++, value);
+    }
+
+    bool test(u32 pos) const { return (data[pos / 64] >> (pos % 64)) & 1; }
+    bool operator[](u32 pos) const { return test(pos); }
+
+    void set(u32 pos) { data[pos / 64] |= 1ULL << (pos % 64); }
+    void set(u32 pos, bool value) { value ? set(pos) : reset(pos); }
+    void reset(u32 pos) { data[pos / 64] &= ~(1ULL << (pos % 64)); }
+    void flip(u32 pos) { data[pos / 64] ^= 1ULL << (pos % 64); }
+
+    void set_all() {
+        for(u32 i = 0; i < word_total(); i++) data[i] = ~0ULL;
+        trim();
+    }
+
+    void clear() {
+        for(u32 i = 0; i < word_total(); i++) data[i] = 0;
+    }
+
+    void flip_all() {
+        for(u32 i = 0; i < word_total(); i++) data[i] = ~data[i];
+        trim();
+    }
+
+    u32 count() const { return (u32)detail::bits_count(data, word_total()); }
+    bool any() const { return find_first() >= 0; }
+    bool none() const { return !any(); }
+    bool all() const { return count() == bits; }
+
+    i32 find_first() const { return detail::bits_find(data, bits, 0, 0); }
+    i32 find_next(u32 from) const { return detail::bits_find(data, bits, from, 0); }
+    i32 find_first_clear() const { return detail::bits_find(data, bits, 0, ~0ULL); }
+    i32 find_next_clear(u32 from) const { return detail::bits_find(data, bits, from, ~0ULL); }
+
+    template<typename F>
+    void for_each_set(F fn) const {
+        for(u32 i = 0; i < word_total(); i++) {
+            for(u64 w = data[i]; w; w &= w - 1) fn(i * 64 + (u32)__builtin_ctzll(w));
+        }
+    }
+
+    u32 rank(u32 pos) const { return detail::bits_rank(data, pos); }
+    i32 select(u32 k) const { return detail::bits_select(data, word_total(), k); }
+
+    dynamic_bitset& operator&=(const dynamic_bitset& other) {
+        u32 words = word_total() < other.word_total() ? word_total() : other.word_total();
+        detail::bits_apply<detail::bit_op::and_>(data, other.data, words);
+        for(u32 i = words; i < word_total(); i++) data[i] = 0;
+        return *this;
+    }
+
+    dynamic_bitset& operator|=(const dynamic_bitset& other) {
+        u32 words = word_total() < other.word_total() ? word_total() : other.word_total();
+        detail::bits_apply<detail::bit_op::or_>(data, other.data, words);
+        trim();
+        return *this;
+    }
+
+    dynamic_bitset& operator^=(const dynamic_bitset& other) {
+        u32 words = word_total() < other.word_total() ? word_total() : other.word_total();
+        detail::bits_apply<detail::bit_op::xor_>(data, other.data, words);
+        trim();
+        return *this;
+    }
+
+    dynamic_bitset& and_not(const dynamic_bitset& other) {
+        u32 words = word_total() < other.word_total() ? word_total() : other.word_total();
+        detail::bits_apply<detail::bit_op::and_not>(data, other.data, words);
+        return *this;
+    }
+
+    friend dynamic_bitset operator&(dynamic_bitset a, const dynamic_bitset& b) { return move(a &= b); }
+    friend dynamic_bitset operator|(dynamic_bitset a, const dynamic_bitset& b) { return move(a |= b); }
+    friend dynamic_bitset operator^(dynamic_bitset a, const dynamic_bitset& b) { return move(a ^= b); }
+
+    bool operator==(const dynamic_bitset& other) const {
+        return bits == other.bits && memeq_simple(data, other.data, word_total() * 8);
+    }
+    bool operator!=(const dynamic_bitset& other) const { return !(*this == other); }
+
+    u32 size() const { return bits; }
+    bool empty() const { return bits == 0; }
+    u32 word_count() const { return word_total(); }
+    u64* words() { return data; }
+    const u64* words() const { return data; }
+};
+
+// Constant-time rank and fast select over a bitset that no longer changes.
+// Stores the running count before every 512-bit block (8 words): rank is one
+// lookup plus at most eight popcounts, select a binary search over blocks.
+// The bitset must outlive the index and stay unmodified.
+template<typename A = heap_allocator>
+class rank_index {
+private:
+    const u64* data;
+    u32 bits;
+    u32 blocks;
+    u32* counts;
+    [[no_unique_address]] A alloc;
+
+public:
+    template<typename B>
+    explicit rank_index(const B& set, const A& a = A()) : data(set.words()), bits(set.size()), alloc(a) {
+        u32 words = set.word_count();
+        blocks = (words + 7) / 8;
+        counts = (u32*)alloc.allocate((u64)(blocks + 1) * sizeof(u32));
+        u32 total = 0;
+        for(u32 b = 0; b < blocks; b++) {
+            counts[b] = total;
+            u32 n = words - b * 8 < 8 ? words - b * 8 : 8;
+            total += (u32)detail::bits_count(data + b * 8, n);
+        }
+        counts[blocks] = total;
+    }
+
+    rank_index(const rank_index&) = delete;
+    rank_index& operator=(const rank_index&) = delete;
+
+    ~rank_index() {
+        alloc.deallocate(counts, (u64)(blocks + 1) * sizeof(u32));
+    }
+
+    // Set bits in [0, pos), pos <= size().
+    u32 rank(u32 pos) const {
+        u32 block = pos / 512;
+        u32 n = counts[block];
+        u32 word = block * 8;
+        for(; word < pos / 64; word++) n += (u32)__builtin_popcountll(data[word]);
+        if(pos % 64) n += (u32)__builtin_popcountll(data[word] & ((1ULL << (pos % 64)) - 1));
+        return n;
+    }
+
+    // Position of the k-th (0-based) set bit, -1 if fewer are set.
+    i32 select(u32 k) const {
+        if(k >= counts[blocks]) return -1;
+        u32 lo = 0, hi = blocks;
+        while(hi - lo > 1) {
+            u32 mid = (lo + hi) / 2;
+            if(counts[mid] <= k) lo = mid;
+            else hi = mid;
+        }
+        k -= counts[lo];
+        for(u32 word = lo * 8;; word++) {
+            u32 n = (u32)__builtin_popcountll(data[word]);
+            if(k < n) return (i32)(word * 64 + detail::select_in_word(data[word], k));
+            k -= n;
+        }
+    }
+
+    u32 ones() const { return counts[blocks]; }
+    u32 size() const { return bits; }
+};
+
+i32 abs(i32 x) { return x < 0 ? -x : x; }
+f64 abs(f64 x) { return x < 0 ? -x : x; }
+
+f64 pow(f64 base, i32 exp) {
+    f64 result = 1.0;
+    bool negative = exp < 0;
+    u32 abs_exp = negative ? -exp : exp;
+    
+    for(u32 i = 0; i < abs_exp; i++) result *= base;
+    return negative ? 1.0 / result : result;
+}
+
+i32 min(i32 a, i32 b) { return a < b ? a : b; }
+i32 max(i32 a, i32 b) { return a > b ? a : b; }
+f64 min(f64 a, f64 b) { return a < b ? a : b; }
+f64 max(f64 a, f64 b) { return a > b ? a : b; }
+
+struct less {
+    template<typename T>
+    bool operator()(const T& a, const T& b) const { return a < b; }
+};
+
+namespace detail {
+
+static constexpr u32 insertion_sort_threshold = 24;
+static constexpr u32 ninther_threshold = 128;
+static constexpr u32 partial_insertion_limit = 8;
+
+template<typename T, typename C>
+void insertion_sort(T* begin, T* end, C& comp) {
+    if(begin == end) return;
+    for(T* cur = begin + 1; cur != end; cur++) {
+        T* sift = cur;
+        T* sift_1 = cur - 1;
+        if(comp(*sift, *sift_1)) {
+            T tmp = move(*sift);
+            do {
+                *sift-- = move(*sift_1);
+            } while(sift != begin && comp(tmp, *--sift_1));
+            *sift = move(tmp);
+        }
+    }
+}
+
+template<typename T, typename C>
+void unguarded_insertion_sort(T* begin, T* end, C& comp) {
+    if(begin == end) return;
+    for(T* cur = begin + 1; cur != end; cur++) {
+        T* sift = cur;
+        T* sift_1 = cur - 1;
+        if(comp(*sift, *sift_1)) {
+            T tmp = move(*sift);
+            do {
+                *sift-- = move(*sift_1);
+            } while(comp(tmp, *--sift_1));
+            *sift = move(tmp);
+        }
+    }
+}
+
+template<typename T, typename C>
+bool partial_insertion_sort(T* begin, T* end, C& comp) {
+    if(begin == end) return true;
+    u32 moved = 0;
+    for(T* cur = begin + 1; cur != end; cur++) {
+        T* sift = cur;
+        T* sift_1 = cur - 1;
+        if(comp(*sift, *sift_1)) {
+            T tmp = move(*sift);
+            do {
+                *sift-- = move(*sift_1);
+            } while(sift != begin && comp(tmp, *--sift_1));
+            *sift = move(tmp);
+            moved += (u32)(cur - sift);
+        }
+        if(moved > partial_insertion_limit) return false;
+    }
+    return true;
+}
+
+template<typename T, typename C>
+void sort2(T* a, T* b, C& comp) {
+    if(comp(*b, *a)) swap(*a, *b);
+}
+
+template<typename T, typename C>
+void sort3(T* a, T* b, T* c, C& comp) {
+    sort2(a, b, comp);
+    sort2(b, c, comp);
+    sort2(a, b, comp);
+}
+
+template<typename T, typename C>
+void sift_down(T* heap, u32 root, u32 size, C& comp) {
+    T value = move(heap[root]);
+    while(true) {
+        u32 child = root * 2 + 1;
+        if(child >= size) break;
+        if(child + 1 < size && comp(heap[child], heap[child + 1])) child++;
+        if(!comp(value, heap[child])) break;
+        heap[root] = move(heap[child]);
+        root = child;
+    }
+    heap[root] = move(value);
+}
+
+template<typename T, typename C>
+void heap_sort(T* begin, T* end, C& comp) {
+    u32 size = (u32)(end - begin);
+    for(u32 i = size / 2; i > 0; i--) sift_down(begin, i - 1, size, comp);
+    for(u32 i = size - 1; i > 0; i--) {
+        swap(begin[0], begin[i]);
+        sift_down(begin, 0, i, comp);
+    }
+}
+
+// Elements equal to the pivot end up on the right. Returns the pivot position and
+// whether the range was already partitioned (no swaps were needed).
+template<typename T, typename C>
+pair<T*, bool> partition_right(T* begin, T* end, C& comp) {
+    T pivot(move(*begin));
+    T* first = begin;
+    T* last = end;
+
+    while(comp(*++first, pivot));
+    if(first - 1 == begin) {
+        while(first < last && !comp(*--last, pivot));
+    } else {
+        while(!comp(*--last, pivot));
+    }
+
+    bool already_partitioned = first >= last;
+    while(first < last) {
+        swap(*first, *last);
+        while(comp(*++first, pivot));
+        while(!comp(*--last, pivot));
+    }
+
+    T* pivot_pos = first - 1;
+    *begin = move(*pivot_pos);
+    *pivot_pos = move(pivot);
+    return pair<T*, bool>(pivot_pos, already_partitioned);
+}
+
+// Elements equal to the pivot end up on the left; used when the pivot equals the
+// element just before the range, so the whole equal run can be skipped.
+template<typename T, typename C>
+T* partition_left(T* begin, T* end, C& comp) {
+    T pivot(move(*begin));
+    T* first = begin;
+    T* last = end;
+
+    while(comp(pivot, *--last));
+    if(last + 1 == end) {
+        while(first < last && !comp(pivot, *++first));
+    } else {
+        while(!comp(pivot, *++first));
+    }
+
+    while(first < last) {
+        swap(*first, *last);
+        while(comp(pivot, *--last));
+        while(!comp(pivot, *++first));
+    }
+
+    T* pivot_pos = last;
+    *begin = move(*pivot_pos);
+    *pivot_pos = move(pivot);
+    return pivot_pos;
+}
+
+template<typename T, typename C>
+void pdqsort_loop(T* begin, T* end, C& comp, u32 bad_allowed, bool leftmost) {
+    while(true) {
+        u32 size = (u32)(end - begin);
+        if(size < insertion_sort_threshold) {
+            if(leftmost) insertion_sort(begin, end, comp);
+            else unguarded_insertion_sort(begin, end, comp);
+            return;
+        }
+
+        u32 half = size / 2;
+        if(size > ninther_threshold) {
+            sort3(begin, begin + half, end - 1, comp);
+            sort3(begin + 1, begin + (half - 1), end - 2, comp);
+            sort3(begin + 2, begin + (half + 1), end - 3, comp);
+            sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+            swap(*begin, *(begin + half));
+        } else {
+            sort3(begin + half, begin, end - 1, comp);
+        }
+
+        if(!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        pair<T*, bool> part = partition_right(begin, end, comp);
+        T* pivot_pos = part.first;
+        u32 l_size = (u32)(pivot_pos - begin);
+        u32 r_size = (u32)(end - (pivot_pos + 1));
+
+        if(l_size < size / 8 || r_size < size / 8) {
+            if(--bad_allowed == 0) {
+                heap_sort(begin, end, comp);
+                return;
+            }
+
+            if(l_size >= insertion_sort_threshold) {
+                swap(*begin, *(begin + l_size / 4));
+                swap(*(pivot_pos - 1), *(pivot_pos - l_size / 4));
+                if(l_size > ninther_threshold) {
+                    swap(*(begin + 1), *(begin + (l_size / 4 + 1)));
+                    swap(*(begin + 2), *(begin + (l_size / 4 + 2)));
+                    swap(*(pivot_pos - 2), *(pivot_pos - (l_size / 4 + 1)));
+                    swap(*(pivot_pos - 3), *(pivot_pos - (l_size / 4 + 2)));
+                }
+            }
+
+            if(r_size >= insertion_sort_threshold) {
+                swap(*(pivot_pos + 1), *(pivot_pos + (1 + r_size / 4)));
+                swap(*(end - 1), *(end - r_size / 4));
+                if(r_size > ninther_threshold) {
+                    swap(*(pivot_pos + 2), *(pivot_pos + (2 + r_size / 4)));
+                    swap(*(pivot_pos + 3), *(pivot_pos + (3 + r_size / 4)));
+                    swap(*(end - 2), *(end - (1 + r_size / 4)));
+                    swap(*(end - 3), *(end - (2 + r_size / 4)));
+                }
+            }
+        } else if(part.second
+                  && partial_insertion_sort(begin, pivot_pos, comp)
+                  && partial_insertion_sort(pivot_pos + 1, end, comp)) {
+            return;
+        }
+
+        pdqsort_loop(begin, pivot_pos, comp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template<typename T, typename C>
+void merge_sort(T* arr, u32 size, T* buffer, C& comp) {
+    if(size <= insertion_sort_threshold) {
+        insertion_sort(arr, arr + size, comp);
+        return;
+    }
+
+    u32 mid = size / 2;
+    merge_sort(arr, mid, buffer, comp);
+    merge_sort(arr + mid, size - mid, buffer, comp);
+    if(!comp(arr[mid], arr[mid - 1])) return;
+
+    for(u32 i = 0; i < mid; i++) new (&buffer[i]) T(move(arr[i]));
+
+    u32 i = 0, j = mid, k = 0;
+    while(i < mid && j < size) {
+        if(comp(arr[j], buffer[i])) arr[k++] = move(arr[j++]);
+        else arr[k++] = move(buffer[i++]);
+    }
+    while(i < mid) arr[k++] = move(buffer[i++]);
+
+    for(u32 n = 0; n < mid; n++) buffer[n].~T();
+}
+
+template<typename T> struct radix_key;
+
+template<> struct radix_key<u32> {
+    using type = u32;
+    static u32 get(u32 v) { return v; }
+};
+
+template<> struct radix_key<u64> {
+    using type = u64;
+    static u64 get(u64 v) { return v; }
+};
+
+template<> struct radix_key<i32> {
+    using type = u32;
+    static u32 get(i32 v) { return (u32)v ^ 0x80000000u; }
+};
+
+template<> struct radix_key<i64> {
+    using type = u64;
+    static u64 get(i64 v) { return (u64)v ^ 0x8000000000000000ULL; }
+};
+
+template<> struct radix_key<f32> {
+    using type = u32;
+    static u32 get(f32 v) {
+        u32 bits;
+        memcpy_simple(&bits, &v, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    }
+};
+
+template<> struct radix_key<f64> {
+    using type = u64;
+    static u64 get(f64 v) {
+        u64 bits;
+        memcpy_simple(&bits, &v, sizeof(bits));
+        return (bits & 0x8000000000000000ULL) ? ~bits : bits | 0x8000000000000000ULL;
+    }
+};
+
+}
+
+template<typename T, typename C>
+void sort(T* arr, u32 size, C comp) {
+    if(size < 2) return;
+    u32 bad_allowed = 1;
+    for(u32 n = size; n > 1; n >>= 1) bad_allowed++;
+    detail::pdqsort_loop(arr, arr + size, comp, bad_allowed, true);
+}
+
+template<typename T>
+void sort(T* arr, u32 size) {
+    sort(arr, size, less());
+}
+
+template<typename T, typename K>
+void sort_by_key(T* arr, u32 size, K key) {
+    sort(arr, size, [&key](const T& a, const T& b) { return key(a) < key(b); });
+}
+
+template<typename T, typename C>
+void stable_sort(T* arr, u32 size, C comp) {
+    if(size < 2) return;
+    if(size <= detail::insertion_sort_threshold) {
+        detail::insertion_sort(arr, arr + size, comp);
+        return;
+    }
+    T* buffer = (T*)detail::heap_alloc(sizeof(T) * (size / 2 + 1));
+    detail::merge_sort(arr, size, buffer, comp);
+    detail::heap_free(buffer);
+}
+
+template<typename T>
+void stable_sort(T* arr, u32 size) {
+    stable_sort(arr, size, less());
+}
+
+template<typename T, typename K>
+void stable_sort_by_key(T* arr, u32 size, K key) {
+    stable_sort(arr, size, [&key](const T& a, const T& b) { return key(a) < key(b); });
+}
+
+// LSD radix sort on 8-bit digits for u32, i32, u64, i64, f32 and f64. Digits on
+// which every key agrees are skipped.
+template<typename T>
+void radix_sort(T* arr, u32 size) {
+    using key = detail::radix_key<T>;
+    using K = typename key::type;
+    constexpr u32 passes = sizeof(K);
+
+    if(size <= detail::insertion_sort_threshold) {
+        sort(arr, size);
+        return;
+    }
+
+    u32* counts = (u32*)detail::heap_alloc(sizeof(u32) * passes * 256);
+    for(u32 i = 0; i < passes * 256; i++) counts[i] = 0;
+    for(u32 i = 0; i < size; i++) {
+        K k = key::get(arr[i]);
+        for(u32 p = 0; p < passes; p++) counts[p * 256 + ((k >> (p * 8)) & 0xFF)]++;
+    }
+
+    T* tmp = (T*)detail::heap_alloc(sizeof(T) * size);
+    T* src = arr;
+    T* dst = tmp;
+    for(u32 p = 0; p < passes; p++) {
+        u32* c = counts + p * 256;
+        if(c[(key::get(src[0]) >> (p * 8)) & 0xFF] == size) continue;
+
+        u32 sum = 0;
+        for(u32 b = 0; b < 256; b++) {
+            u32 n = c[b];
+            c[b] = sum;
+            sum += n;
+        }
+        for(u32 i = 0; i < size; i++) {
+            dst[c[(key::get(src[i]) >> (p * 8)) & 0xFF]++] = src[i];
+        }
+        swap(src, dst);
+    }
+
+    if(src != arr) memcpy_simple(arr, src, sizeof(T) * size);
+    detail::heap_free(tmp);
+    detail::heap_free(counts);
+}
+
+template<typename T, typename A> void sort(vector<T, A>& v) { sort(v.begin(), v.size()); }
+template<typename T, typename A, typename C> void sort(vector<T, A>& v, C comp) { sort(v.begin(), v.size(), comp); }
+template<typename T, typename A, typename K> void sort_by_key(vector<T, A>& v, K key) { sort_by_key(v.begin(), v.size(), key); }
+template<typename T, typename A> void stable_sort(vector<T, A>& v) { stable_sort(v.begin(), v.size()); }
+template<typename T, typename A, typename C> void stable_sort(vector<T, A>& v, C comp) { stable_sort(v.begin(), v.size(), comp); }
+template<typename T, typename A, typename K> void stable_sort_by_key(vector<T, A>& v, K key) { stable_sort_by_key(v.begin(), v.size(), key); }
+template<typename T, typename A> void radix_sort(vector<T, A>& v) { radix_sort(v.begin(), v.size()); }
+
+template<typename T, typename A> void sort(array<T, A>& arr) { sort(arr.begin(), arr.size()); }
+template<typename T, typename A, typename C> void sort(array<T, A>& arr, C comp) { sort(arr.begin(), arr.size(), comp); }
+template<typename T, typename A, typename K> void sort_by_key(array<T, A>& arr, K key) { sort_by_key(arr.begin(), arr.size(), key); }
+template<typename T, typename A> void stable_sort(array<T, A>& arr) { stable_sort(arr.begin(), arr.size()); }
+template<typename T, typename A, typename C> void stable_sort(array<T, A>& arr, C comp) { stable_sort(arr.begin(), arr.size(), comp); }
+template<typename T, typename A, typename K> void stable_sort_by_key(array<T, A>& arr, K key) { stable_sort_by_key(arr.begin(), arr.size(), key); }
+template<typename T, typename A> void radix_sort(array<T, A>& arr) { radix_sort(arr.begin(), arr.size()); }
+
+template<typename T>
+i32 find(const T* arr, u32 size, const T& value)
+{
+    for(u32 i = 0; i < size; i++) 
+    {
+        if(arr[i] == value) return i;
+    }
+    return -1;
+}
+
+// Seeding and stream-splitting helper; also a fast generator on its own.
+class splitmix64 {
+private:
+    u64 state;
+
+public:
+    splitmix64(u64 seed = 0) : state(seed) {}
+
+    u64 next() {
+        u64 z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    splitmix64 split() { return splitmix64(next()); }
+};
+
+// xoshiro256** (Blackman & Vigna). Period 2^256 - 1; jump() advances 2^128.
+class xoshiro256 {
+private:
+    u64 s[4];
+
+    static u64 rotl(u64 x, u32 k) { return (x << k) | (x >> (64 - k)); }
+
+#ifdef RAZ_SIMD_AVX2
+    static __m256i rotl4(__m256i x, int k) {
+        return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+    }
+#endif
+
+    // Four generators side by side (AVX2 lanes when available, x*5 and x*9
+    // become shifts and adds). Lane 0 continues this stream; lanes 1-3 are
+    // reseeded from it. Both paths produce the same values and final state.
+    void fill_lanes(u64* out, u64 n) {
+        alignas(32) u64 init[4][4];
+        for(u32 j = 0; j < 4; j++) init[j][0] = s[j];
+        for(u32 lane = 1; lane < 4; lane++) {
+            splitmix64 sm(next());
+            for(u32 j = 0; j < 4; j++) init[j][lane] = sm.next();
+        }
+        u64 blocks = n / 4;
+#ifdef RAZ_SIMD_AVX2
+        __m256i s0 = _mm256_load_si256((const __m256i*)init[0]);
+        __m256i s1 = _mm256_load_si256((const __m256i*)init[1]);
+        __m256i s2 = _mm256_load_si256((const __m256i*)init[2]);
+        __m256i s3 = _mm256_load_si256((const __m256i*)init[3]);
+        for(u64 i = 0; i < blocks; i++) {
+            __m256i x = _mm256_add_epi64(s1, _mm256_slli_epi64(s1, 2));
+            x = rotl4(x, 7);
+            x = _mm256_add_epi64(x, _mm256_slli_epi64(x, 3));
+            _mm256_storeu_si256((__m256i*)(out + i * 4), x);
+            __m256i t = _mm256_slli_epi64(s1, 17);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = rotl4(s3, 45);
+        }
+        s[0] = (u64)_mm256_extract_epi64(s0, 0);
+        s[1] = (u64)_mm256_extract_epi64(s1, 0);
+        s[2] = (u64)_mm256_extract_epi64(s2, 0);
+        s[3] = (u64)_mm256_extract_epi64(s3, 0);
+#else
+        u64 s0[4], s1[4], s2[4], s3[4];
+        for(u32 lane = 0; lane < 4; lane++) {
+            s0[lane] = init[0][lane];
+            s1[lane] = init[1][lane];
+            s2[lane] = init[2][lane];
+            s3[lane] = init[3][lane];
+        }
+        for(u64 i = 0; i < blocks; i++) {
+            u64 x[4];
+            for(u32 lane = 0; lane < 4; lane++) {
+                x[lane] = rotl(s1[lane] * 5, 7) * 9;
+                u64 t = s1[lane] << 17;
+                s2[lane] ^= s0[lane];
+                s3[lane] ^= s1[lane];
+                s1[lane] ^= s2[lane];
+                s0[lane] ^= s3[lane];
+                s2[lane] ^= t;
+                s3[lane] = rotl(s3[lane], 45);
+            }
+            memcpy_simple(out + i * 4, x, sizeof(x));
+        }
+        s[0] = s0[0];
+        s[1] = s1[0];
+        s[2] = s2[0];
+        s[3] = s3[0];
+#endif
+        for(u64 i = blocks * 4; i < n; i++) out[i] = next();
+    }
+
+public:
+    xoshiro256(u64 seed = 0) {
+        splitmix64 sm(seed);
+        for(u32 i = 0; i < 4; i++) s[i] = sm.next();
+    }
+
+    u64 next() {
+        u64 result = rotl(s[1] * 5, 7) * 9;
+        u64 t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    void jump() {
+        static constexpr u64 table[] = {
+            0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+            0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+        };
+        u64 t[4] = {0, 0, 0, 0};
+        for(u32 i = 0; i < 4; i++) {
+            for(u32 b = 0; b < 64; b++) {
+                if(table[i] & (1ULL << b)) {
+                    for(u32 j = 0; j < 4; j++) t[j] ^= s[j];
+                }
+                next();
+            }
+        }
+        for(u32 j = 0; j < 4; j++) s[j] = t[j];
+    }
+
+    // Returns the current stream and moves this one 2^128 steps ahead.
+    xoshiro256 split() {
+        xoshiro256 other = *this;
+        jump();
+        return other;
+    }
+
+    // Runs of 64 or more come from fill_lanes(), so they differ from n calls
+    // of next() but not between builds.
+    void fill(u64* out, u64 n) {
+        if(n >= 64) {
+            fill_lanes(out, n);
+            return;
+        }
+        for(u64 i = 0; i < n; i++) out[i] = next();
+    }
+};
+
+// PCG64 (XSL-RR 128/64, O'Neill). Each odd increment selects a distinct stream.
+class pcg64 {
+private:
+    u64 state_hi, state_lo;
+    u64 inc_hi, inc_lo;
+
+    static constexpr u64 mult_hi = 2549297995355413924ULL;
+    static constexpr u64 mult_lo = 4865540595714422341ULL;
+
+    void step() {
+        u64 hi;
+        u64 lo = detail::mul_128(state_lo, mult_lo, hi);
+        hi += state_lo * mult_hi + state_hi * mult_lo;
+        state_lo = lo + inc_lo;
+        state_hi = hi + inc_hi + (state_lo < lo);
+    }
+
+public:
+    pcg64(u64 seed = 0, u64 stream = 0) {
+        splitmix64 sm(stream);
+        inc_hi = sm.next();
+        inc_lo = sm.next() | 1;
+        state_hi = 0;
+        state_lo = 0;
+        step();
+        splitmix64 ss(seed);
+        u64 add_hi = ss.next(), add_lo = ss.next();
+        state_lo += add_lo;
+        state_hi += add_hi + (state_lo < add_lo);
+        step();
+    }
+
+    u64 next() {
+        step();
+        u64 x = state_hi ^ state_lo;
+        u32 rot = (u32)(state_hi >> 58);
+        return (x >> rot) | (x << ((64 - rot) & 63));
+    }
+
+    pcg64 split() { return pcg64(next(), next()); }
+
+    void fill(u64* out, u64 n) {
+        for(u64 i = 0; i < n; i++) out[i] = next();
+    }
+};
+
+// Distribution layer over any engine with `u64 next()`, `split()` and `fill()`.
+template<typename E>
+class basic_random {
+private:
+    E engine;
+
+    static constexpr u32 fill_chunk = 256;
+
+public:
+    basic_random(u64 initial_seed = 12345) : engine(initial_seed) {}
+    basic_random(const E& e) : engine(e) {}
+
+    u64 next_u64() { return engine.next(); }
+    u32 next() { return (u32)(engine.next() >> 32); }
+
+    // Uniform in [0, bound), unbiased (Lemire's multiply-shift with rejection).
+    u64 bounded(u64 bound) {
+        u64 hi;
+        u64 lo = detail::mul_128(engine.next(), bound, hi);
+        if(lo < bound) {
+            u64 threshold = (0 - bound) % bound;
+            while(lo < threshold) lo = detail::mul_128(engine.next(), bound, hi);
+        }
+        return hi;
+    }
+
+    u32 bounded(u32 bound) {
+        u64 m = (engine.next() >> 32) * bound;
+        u32 lo = (u32)m;
+        if(lo < bound) {
+            u32 threshold = (0u - bound) % bound;
+            while(lo < threshold) {
+                m = (engine.next() >> 32) * bound;
+                lo = (u32)m;
+            }
+        }
+        return (u32)(m >> 32);
+    }
+
+    // Inclusive on both ends; the full u32 range is allowed.
+    u32 range(u32 min, u32 max) {
+        if(min == 0 && max == 0xFFFFFFFFu) return next();
+        return min + bounded(max - min + 1);
+    }
+
+    u64 range_u64(u64 min, u64 max) {
+        if(min == 0 && max == ~0ULL) return engine.next();
+        return min + bounded(max - min + 1);
+    }
+
+    i64 range_i64(i64 min, i64 max) {
+        return (i64)((u64)min + range_u64(0, (u64)max - (u64)min));
+    }
+
+    // [0, 1) with 53 and 24 random bits.
+    f64 next_f64() { return (f64)(engine.next() >> 11) * 0x1.0p-53; }
+    f32 next_f32() { return (f32)(engine.next() >> 40) * 0x1.0p-24f; }
+
+    f64 float_range(f64 min, f64 max) {
+        return min + next_f64() * (max - min);
+    }
+
+    void fill(u64* out, u64 n) { engine.fill(out, n); }
+
+    void fill(u32* out, u64 n) {
+        u64 tmp[fill_chunk];
+        while(n > 0) {
+            u64 words = (n + 1) / 2 < fill_chunk ? (n + 1) / 2 : fill_chunk;
+            engine.fill(tmp, words);
+            for(u64 i = 0; i < words && n > 0; i++) {
+                *out++ = (u32)tmp[i];
+                if(--n > 0) {
+                    *out++ = (u32)(tmp[i] >> 32);
+                    n--;
+                }
+            }
+        }
+    }
+
+    void fill(f64* out, u64 n) {
+        u64 tmp[fill_chunk];
+        while(n > 0) {
+            u64 count = n < fill_chunk ? n : fill_chunk;
+            engine.fill(tmp, count);
+            for(u64 i = 0; i < count; i++) out[i] = (f64)(tmp[i] >> 11) * 0x1.0p-53;
+            out += count;
+            n -= count;
+        }
+    }
+
+    // Fisher-Yates.
+    template<typename T>
+    void shuffle(T* data, u32 size) {
+        for(u32 i = size; i > 1; i--) {
+            u32 j = bounded(i);
+            swap(data[i - 1], data[j]);
+        }
+    }
+
+    template<typename T, typename A>
+    void shuffle(vector<T, A>& vec) { shuffle(vec.begin(), vec.size()); }
+
+    template<typename T, typename A>
+    void shuffle(array<T, A>& arr) { shuffle(arr.begin(), arr.size()); }
+
+    // Independent generator for another thread or task.
+    basic_random split() { return basic_random(engine.split()); }
+
+    E& get_engine() { return engine; }
+};
+
+using random = basic_random<xoshiro256>;
+using random_pcg = basic_random<pcg64>;
+using random_splitmix = basic_random<splitmix64>;
+
+template<typename T, typename A = heap_allocator>
+class deque {
+private:
+    T* data;
+    u32 head;
+    u32 len;
+    u32 cap;
+    [[no_unique_address]] A alloc;
+
+    static constexpr u32 min_cap = 8;
+
+    u32 wrap(u32 index) const { return index & (cap - 1); }
+
+    u32 next_cap() const { return cap ? cap * 2 : min_cap; }
+
+    void grow(u32 new_cap) {
+        T* new_data = (T*)alloc.allocate(sizeof(T) * new_cap);
+        RAZ_STAT(stats.deques.record_alloc(sizeof(T) * new_cap, new_cap));
+        RAZ_STAT(stats.deques.record_growth());
+        for(u32 i = 0; i < len; i++) {
+            T& item = data[wrap(head + i)];
+            new (&new_data[i]) T(move(item));
+            item.~T();
+        }
+        alloc.deallocate(data, sizeof(T) * cap);
+        data = new_data;
+        head = 0;
+        cap = new_cap;
+    }
+
+public:
+    deque(const A& a = A()) : head(0), len(0), cap(min_cap), alloc(a) {
+        data = (T*)alloc.allocate(sizeof(T) * cap);
+        RAZ_STAT(stats.deques.record_alloc(sizeof(T) * cap, cap));
+    }
+
+    deque(const deque& other) : head(0), len(0), cap(other.cap ? other.cap : min_cap), alloc(other.alloc) {
+        RAZ_STAT(stats.deques.record_copy());
+        data = (T*)alloc.allocate(sizeof(T) * cap);
+        RAZ_STAT(stats.deques.record_alloc(sizeof(T) * cap, cap));
+        for(u32 i = 0; i < other.len; i++) push_back(other[i]);
+    }
+
+    // Leaves `other` empty without a buffer; it allocates again on first use.
+    deque(deque&& other) : data(other.data), head(other.head), len(other.len), cap(other.cap), alloc(other.alloc) {
+        other.data = nullptr;
+        other.head = 0;
+        other.len = 0;
+        other.cap = 0;
+    }
+
+    deque& operator=(const deque& other) {
+        if(this != &other) {
+            RAZ_STAT(stats.deques.record_copy());
+            clear();
+            reserve(other.len);
+            for(u32 i = 0; i < other.len; i++) push_back(other[i]);
+        }
+        return *this;
+    }
+
+    deque& operator=(deque&& other) {
+        if(this != &other) {
+            swap(data, other.data);
+            swap(head, other.head);
+            swap(len, other.len);
+            swap(cap, other.cap);
+            swap(alloc, other.alloc);
+        }
+        return *this;
+    }
+
+    ~deque() {
+        clear();
+        alloc.deallocate(data, sizeof(T) * cap);
+    }
+
+    void reserve(u32 count) {
+        if(count <= cap) return;
+        u32 new_cap = next_cap();
+        while(new_cap < count) new_cap *= 2;
+        grow(new_cap);
+    }
+
+    // `value` may live in this deque, so it is taken before grow() moves the
+    // elements out from under it.
+    void push_back(const T& value) {
+        if(len == cap) {
+            T item(value);
+            grow(next_cap());
+            new (&data[len]) T(move(item));
+        } else {
+            new (&data[wrap(head + len)]) T(value);
+        }
+        len++;
+    }
+
+    void push_back(T&& value) {
+        if(len == cap) {
+            T item(move(value));
+            grow(next_cap());
+            new (&data[len]) T(move(item));
+        } else {
+            new (&data[wrap(head + len)]) T(move(value));
+        }
+        len++;
+    }
+
+    void push_front(const T& value) {
+        if(len == cap) {
+            T item(value);
+            grow(next_cap());
+            head = wrap(head - 1);
+            new (&data[head]) T(move(item));
+        } else {
+            head = wrap(head - 1);
+            new (&data[head]) T(value);
+        }
+        len++;
+    }
+
+    void push_front(T&& value) {
+        if(len == cap) {
+            T item(move(value));
+            grow(next_cap());
+            head = wrap(head - 1);
+            new (&data[head]) T(move(item));
+        } else {
+            head = wrap(head - 1);
+            new (&data[head]) T(move(value));
+        }
+        len++;
+    }
+
+    void pop_front() {
+        if(len == 0) return;
+        data[head].~T();
+        head = wrap(head + 1);
+        len--;
+    }
+
+    void pop_back() {
+        if(len == 0) return;
+        len--;
+        data[wrap(head + len)].~T();
+    }
+
+    T& operator[](u32 index) { return data[wrap(head + index)]; }
+    const T& operator[](u32 index) const { return data[wrap(head + index)]; }
+
+    T& front() { return data[head]; }
+    T& back() { return data[wrap(head + len - 1)]; }
+    const T& front() const { return data[head]; }
+    const T& back() const { return data[wrap(head + len - 1)]; }
+
+    u32 size() const { return len; }
+    u32 capacity() const { return cap; }
+    bool empty() const { return len == 0; }
+
+    void clear() {
+        for(u32 i = 0; i < len; i++) data[wrap(head + i)].~T();
+        head = 0;
+        len = 0;
+    }
+};
+
+template<typename T, typename A = heap_allocator>
+class queue {
+private:
+    deque<T, A> data;
+
+public:
+    queue(const A& a = A()) : data(a) {}
+
+    void push(const T& value) { data.push_back(value); }
+    void push(T&& value) { data.push_back(move(value)); }
+    void pop() { data.pop_front(); }
+    T& front() { return data.front(); }
+    const T& front() const { return data.front(); }
+    T& back() { return data.back(); }
+    const T& back() const { return data.back(); }
+    bool empty() const { return data.empty(); }
+    u32 size() const { return data.size(); }
+    void reserve(u32 count) { data.reserve(count); }
+};
+
+template<typename T, typename A = heap_allocator>
+class stack {
+private:
+    vector<T, A> data;
+
+public:
+    stack(const A& a = A()) : data(a) {}
+
+    void push(const T& value) { data.push_back(value); }
+    void pop() { if(!data.empty()) data.pop_back(); }
+    T& top() { return data.back(); }
+    const T& top() const { return data.back(); }
+    bool empty() const { return data.empty(); }
+    u32 size() const { return data.size(); }
+};
+
+#ifndef RAZ_CACHE_LINE
+#define RAZ_CACHE_LINE 64
+#endif
+
+namespace detail {
+
+inline void cpu_relax() {
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+    #elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+    #endif
+}
+
+}
+
+// Bounded single-producer/single-consumer ring. One thread may push while
+// another pops; each side keeps a cached copy of the other's index so the
+// shared line is only touched when the ring looks full or empty. N must be
+// a power of two. Storage is inline, so nothing is allocated.
+template<typename T, u32 N>
+class spsc_queue {
+private:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "spsc_queue capacity must be a power of two");
+
+    alignas(RAZ_CACHE_LINE) u32 head;
+    u32 cached_tail;
+    alignas(RAZ_CACHE_LINE) u32 tail;
+    u32 cached_head;
+    alignas(RAZ_CACHE_LINE) alignas(T) u8 storage[sizeof(T) * N];
+
+    T* slot(u32 index) { return (T*)storage + (index & (N - 1)); }
+
+    // Free slots as seen by the producer.
+    u32 writable(u32 t) {
+        if(t - cached_head == N) cached_head = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+        return N - (t - cached_head);
+    }
+
+    // Filled slots as seen by the consumer.
+    u32 readable(u32 h) {
+        if(cached_tail == h) cached_tail = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+        return cached_tail - h;
+    }
+
+public:
+    spsc_queue() : head(0), cached_tail(0), tail(0), cached_head(0) {}
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    ~spsc_queue() {
+        for(u32 i = head; i != tail; i++) slot(i)->~T();
+    }
+
+    template<typename... Args>
+    bool emplace(Args&&... args) {
+        u32 t = tail;
+        if(writable(t) == 0) return false;
+        new (slot(t)) T(forward<Args>(args)...);
+        __atomic_store_n(&tail, t + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    bool push(const T& value) { return emplace(value); }
+    bool push(T&& value) { return emplace(move(value)); }
+
+    bool pop(T& out) {
+        u32 h = head;
+        if(readable(h) == 0) return false;
+        T* item = slot(h);
+        out = move(*item);
+        item->~T();
+        __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // Pushes as many of `items` as fit and publishes them with one store.
+    u32 push_batch(const T* items, u32 count) {
+        u32 t = tail;
+        u32 n = writable(t);
+        if(n > count) n = count;
+        for(u32 i = 0; i < n; i++) new (slot(t + i)) T(items[i]);
+        if(n) __atomic_store_n(&tail, t + n, __ATOMIC_RELEASE);
+        return n;
+    }
+
+    // Moves up to `count` items into `out` and releases their slots at once.
+    u32 pop_batch(T* out, u32 count) {
+        u32 h = head;
+        u32 n = readable(h);
+        if(n > count) n = count;
+        for(u32 i = 0; i < n; i++) {
+            T* item = slot(h + i);
+            out[i] = move(*item);
+            item->~T();
+        }
+        if(n) __atomic_store_n(&head, h + n, __ATOMIC_RELEASE);
+        return n;
+    }
+
+    // Exact only when neither side is running.
+    u32 size_approx() const {
+        u32 h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+        return __atomic_load_n(&tail, __ATOMIC_ACQUIRE) - h;
+    }
+
+    bool empty() const { return size_approx() == 0; }
+    static constexpr u32 capacity() { return N; }
+};
+
+// Bounded multi-producer/multi-consumer queue (Vyukov). Every cell carries a
+// sequence number telling producers and consumers whose turn it is, so a push
+// or pop is one CAS on the shared position plus one release store. The ring
+// is allocated once by the constructor; capacity is rounded up to a power of
+// two.
+template<typename T, typename A = heap_allocator>
+class mpmc_queue {
+private:
+    struct cell {
+        u64 seq;
+        alignas(T) u8 storage[sizeof(T)];
+
+        T* value() { return (T*)storage; }
+    };
+
+    cell* cells;
+    u64 mask;
+    [[no_unique_address]] A alloc;
+    alignas(RAZ_CACHE_LINE) u64 enqueue_pos;
+    alignas(RAZ_CACHE_LINE) u64 dequeue_pos;
+
+public:
+    explicit mpmc_queue(u32 capacity, const A& a = A()) : alloc(a), enqueue_pos(0), dequeue_pos(0) {
+        u64 cap = 2;
+        while(cap < capacity) cap *= 2;
+        mask = cap - 1;
+        cells = (cell*)alloc.allocate(sizeof(cell) * cap);
+        for(u64 i = 0; i < cap; i++) cells[i].seq = i;
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    ~mpmc_queue() {
+        for(u64 i = dequeue_pos; i != enqueue_pos; i++) cells[i & mask].value()->~T();
+        alloc.deallocate(cells, sizeof(cell) * (mask + 1));
+    }
+
+    template<typename... Args>
+    bool emplace(Args&&... args) {
+        u64 pos = __atomic_load_n(&enqueue_pos, __ATOMIC_RELAXED);
+        cell* c;
+        while(true) {
+            c = &cells[pos & mask];
+            u64 seq = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+            i64 diff = (i64)(seq - pos);
+            if(diff == 0) {
+                if(__atomic_compare_exchange_n(&enqueue_pos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = __atomic_load_n(&enqueue_pos, __ATOMIC_RELAXED);
+            }
+        }
+        new (c->value()) T(forward<Args>(args)...);
+        __atomic_store_n(&c->seq, pos + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    bool push(const T& value) { return emplace(value); }
+    bool push(T&& value) { return emplace(move(value)); }
+
+    bool pop(T& out) {
+        u64 pos = __atomic_load_n(&dequeue_pos, __ATOMIC_RELAXED);
+        cell* c;
+        while(true) {
+            c = &cells[pos & mask];
+            u64 seq = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+            i64 diff = (i64)(seq - (pos + 1));
+            if(diff == 0) {
+                if(__atomic_compare_exchange_n(&dequeue_pos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+            } else if(diff < 0) {
+                return false;
+            } else {
+                pos = __atomic_load_n(&dequeue_pos, __ATOMIC_RELAXED);
+            }
+        }
+        T* item = c->value();
+        out = move(*item);
+        item->~T();
+        __atomic_store_n(&c->seq, pos + mask + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // The consumer side is read first so the result never underflows.
+    u64 size_approx() const {
+        u64 h = __atomic_load_n(&dequeue_pos, __ATOMIC_ACQUIRE);
+        return __atomic_load_n(&enqueue_pos, __ATOMIC_ACQUIRE) - h;
+    }
+
+    bool empty() const { return size_approx() == 0; }
+    u64 capacity() const { return mask + 1; }
+};
+
+#ifndef RAZ_THREAD_STACK_SIZE
+#define RAZ_THREAD_STACK_SIZE (2u << 20)
+#endif
+
+#ifndef RAZ_POOL_DEQUE_SIZE
+#define RAZ_POOL_DEQUE_SIZE 1024
+#endif
+
+// Futex mutex (Drepper's three-state lock): 0 free, 1 locked, 2 locked with
+// waiters. Uncontended lock/unlock is one atomic each and never enters the
+// kernel.
+class mutex {
+private:
+    u32 state;
+
+public:
+    mutex() : state(0) {}
+
+    mutex(const mutex&) = delete;
+    mutex& operator=(const mutex&) = delete;
+
+    bool try_lock() {
+        u32 expected = 0;
+        return __atomic_compare_exchange_n(&state, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+
+    void lock() {
+        for(u32 spin = 0; spin < 64; spin++) {
+            if(try_lock()) return;
+            detail::cpu_relax();
+        }
+        u32 c = __atomic_exchange_n(&state, 2, __ATOMIC_ACQUIRE);
+        while(c != 0) {
+            sys::futex_wait(&state, 2);
+            c = __atomic_exchange_n(&state, 2, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    void unlock() {
+        if(__atomic_exchange_n(&state, 0, __ATOMIC_RELEASE) == 2) sys::futex_wake(&state, 1);
+    }
+};
+
+class lock_guard {
+private:
+    mutex& m;
+
+public:
+    explicit lock_guard(mutex& mtx) : m(mtx) { m.lock(); }
+    ~lock_guard() { m.unlock(); }
+
+    lock_guard(const lock_guard&) = delete;
+    lock_guard& operator=(const lock_guard&) = delete;
+};
+
+namespace detail {
+
+static mutex heap_mutex;
+
+#if RAZ_HAS_SYSCALL
+// Small blocks come from size-class free lists (16-byte steps to 256, then
+// four classes per power of two) carved out of mapped regions; they are reused
+// but never unmapped. Larger blocks get a mapping each, and the last few freed
+// are kept for reuse. A 16-byte header before every block holds its class size
+// or mapping length.
+static constexpr u64 heap_header = 16;
+static constexpr u64 heap_small_max = 256 << 10;
+static constexpr u32 heap_class_count = 56;
+static constexpr u64 heap_region = 4 << 20;
+static constexpr u32 heap_cached_maps = 8;
+static constexpr u64 heap_cached_max = 16 << 20;
+
+struct heap_state {
+    void* bins[heap_class_count];
+    char* cur;
+    char* end;
+    u64* maps[heap_cached_maps];
+    u32 next_map;
+};
+
+static heap_state heap;
+
+inline u32 heap_class(u64 bytes) {
+    if(bytes <= 256) return (u32)((bytes + 15) / 16) - 1;
+    u32 lg = 63 - (u32)__builtin_clzll(bytes - 1);
+    return 16 + (lg - 8) * 4 + (u32)(((bytes - 1) >> (lg - 2)) & 3);
+}
+
+inline u64 heap_class_size(u32 c) {
+    if(c < 16) return (u64)(c + 1) * 16;
+    u32 lg = 8 + (c - 16) / 4;
+    return (1ULL << lg) + (u64)((c - 16) % 4 + 1) * (1ULL << (lg - 2));
+}
+
+// Carves a fresh small block, or maps a large one (reusing a cached mapping
+// that fits).
+__attribute__((noinline)) inline void* heap_refill(u64 bytes) {
+    if(bytes > heap_small_max) {
+        bytes = align_up(bytes, 4096);
+        for(u32 i = 0; i < heap_cached_maps; i++) {
+            u64* block = heap.maps[i];
+            if(block && *block >= bytes && *block / 2 <= bytes) {
+                heap.maps[i] = nullptr;
+                return (char*)block + heap_header;
+            }
+        }
+        u64* block = (u64*)sys::mmap(nullptr, bytes, sys::prot_read | sys::prot_write,
+                                     sys::map_private | sys::map_anonymous);
+        if(!block) __builtin_trap();
+        *block = bytes;
+        return (char*)block + heap_header;
+    }
+    bytes = heap_class_size(heap_class(bytes));
+    if((u64)(heap.end - heap.cur) < bytes) {
+        heap.cur = (char*)sys::mmap(nullptr, heap_region, sys::prot_read | sys::prot_write,
+                                    sys::map_private | sys::map_anonymous);
+        if(!heap.cur) __builtin_trap();
+        heap.end = heap.cur + heap_region;
+    }
+    u64* block = (u64*)heap.cur;
+    heap.cur += bytes;
+    *block = bytes;
+    return (char*)block + heap_header;
+}
+
+__attribute__((noinline)) inline void heap_unmap(u64* block) {
+    if(*block > heap_cached_max) {
+        sys::munmap(block, *block);
+        return;
+    }
+    u64*& slot = heap.maps[heap.next_map];
+    heap.next_map = (heap.next_map + 1) % heap_cached_maps;
+    if(slot) sys::munmap(slot, *slot);
+    slot = block;
+}
+
+// Free blocks link through their first word after the header, so the header
+// stays valid while a block sits in a bin.
+inline void* heap_alloc_unlocked(u64 size) {
+    u64 bytes = size + heap_header;
+    if(bytes <= heap_small_max) {
+        void** bin = &heap.bins[heap_class(bytes)];
+        void* ptr = *bin;
+        if(ptr) {
+            *bin = *(void**)ptr;
+            return ptr;
+        }
+    }
+    return heap_refill(bytes);
+}
+
+inline void heap_free_unlocked(void* ptr) {
+    if(!ptr) return;
+    u64* block = (u64*)((char*)ptr - heap_header);
+    if(*block > heap_small_max) {
+        heap_unmap(block);
+        return;
+    }
+    void** bin = &heap.bins[heap_class(*block)];
+    *(void**)ptr = *bin;
+    *bin = ptr;
+}
+#else
+inline void* heap_alloc_unlocked(u64 size) { return ::operator new(size); }
+inline void heap_free_unlocked(void* ptr) { ::operator delete(ptr); }
+#endif
 
-    void resize(u32 new_cap) {
-        pair<K, V>* new_data = new pair<K, V>[new_cap];
-        for(u32 i = 0; i < len; i++) {
-            new_data[i] = data[i];
+inline void* heap_alloc(u64 size) {
+    if(!__atomic_load_n(&shared_tls_threads, __ATOMIC_ACQUIRE)) return heap_alloc_unlocked(size);
+    heap_mutex.lock();
+    void* ptr = heap_alloc_unlocked(size);
+    heap_mutex.unlock();
+    return ptr;
+}
+
+inline void heap_free(void* ptr) {
+    if(!__atomic_load_n(&shared_tls_threads, __ATOMIC_ACQUIRE)) {
+        heap_free_unlocked(ptr);
+        return;
+    }
+    heap_mutex.lock();
+    heap_free_unlocked(ptr);
+    heap_mutex.unlock();
+}
+
+#ifdef RAZ_CHECK_THREADS
+// Stacks of the live raz::threads, so the checked global new/delete can tell
+// when they are called on one.
+static constexpr u32 checked_stack_slots = 256;
+static u64 checked_stack_begin[checked_stack_slots];
+static u64 checked_stack_size[checked_stack_slots];
+
+inline void register_stack(const u8* stack, u64 size) {
+    for(u32 i = 0; i < checked_stack_slots; i++) {
+        u64 expected = 0;
+        if(__atomic_compare_exchange_n(&checked_stack_begin[i], &expected, (u64)stack, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&checked_stack_size[i], size, __ATOMIC_RELEASE);
+            return;
         }
-        delete[] data;
-        data = new_data;
-        cap = new_cap;
     }
+}
 
-public:
-    map() : data(new pair<K, V>[8]), len(0), cap(8) {}
-    
-    ~map() {
-        delete[] data;
+inline void unregister_stack(const u8* stack) {
+    for(u32 i = 0; i < checked_stack_slots; i++) {
+        if(__atomic_load_n(&checked_stack_begin[i], __ATOMIC_ACQUIRE) != (u64)stack) continue;
+        __atomic_store_n(&checked_stack_size[i], 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&checked_stack_begin[i], 0, __ATOMIC_RELEASE);
+        return;
     }
+}
 
-    void insert(const K& key, const V& value) {
-        for(u32 i = 0; i < len; i++) {
-            if(data[i].first == key) {
-                data[i].second = value;
-                return;
-            }
-        }
-        
-        if(len >= cap) resize(cap * 2);
-        data[len++] = make_pair(key, value);
+inline bool on_thread_stack() {
+    u64 sp = (u64)__builtin_frame_address(0);
+    for(u32 i = 0; i < checked_stack_slots; i++) {
+        u64 begin = __atomic_load_n(&checked_stack_begin[i], __ATOMIC_ACQUIRE);
+        if(begin && sp >= begin && sp < begin + __atomic_load_n(&checked_stack_size[i], __ATOMIC_ACQUIRE)) return true;
     }
+    return false;
+}
+#endif
 
-    optional<V> get(const K& key) const {
-        for(u32 i = 0; i < len; i++) {
-            if(data[i].first == key) {
-                return optional<V>(data[i].second);
-            }
+}
+
+// Kernel thread started with a raw clone(). The stack is its own mmap with a
+// guard page; the tid word the kernel clears at exit and the callable are
+// stored at the top of it, so starting a thread does not touch the heap and
+// the handle can be moved freely. The thread shares the creator's TLS: code it runs
+// must not rely on thread_local or errno, nor call libc's heap (raz's own heap
+// is fine; RAZ_CHECK_THREADS traps on global new/delete). Where threads are
+// unavailable the callable runs to completion inside the constructor.
+class thread {
+private:
+    u8* stack;
+    u64 stack_size;
+    u32* tid;
+
+    template<typename F>
+    static void entry(void* arg) {
+        F* fn = (F*)arg;
+        (*fn)();
+        fn->~F();
+    }
+
+    void release() {
+        #ifdef RAZ_CHECK_THREADS
+        detail::unregister_stack(stack);
+        #endif
+        sys::munmap(stack, stack_size);
+        stack = nullptr;
+        __atomic_sub_fetch(&detail::shared_tls_threads, 1, __ATOMIC_ACQ_REL);
+    }
+
+public:
+    thread() : stack(nullptr), stack_size(0), tid(nullptr) {}
+
+    template<typename F>
+    explicit thread(F fn, u64 size = RAZ_THREAD_STACK_SIZE) : stack(nullptr), stack_size(0), tid(nullptr) {
+        #if RAZ_HAS_THREADS
+        const u64 guard = 4096;
+        u64 total = align_up(size, guard) + guard;
+        void* mem = sys::mmap(nullptr, total, sys::prot_read | sys::prot_write,
+                              sys::map_private | sys::map_anonymous | sys::map_stack);
+        if(!mem) return;
+        sys::mprotect(mem, guard, sys::prot_none);
+
+        u64 end = (u64)mem + total - RAZ_CACHE_LINE;
+        u64 align = alignof(F) > 16 ? alignof(F) : 16;
+        u64 top = (end - sizeof(F)) & ~(align - 1);
+        F* slot = new ((void*)top) F(move(fn));
+        stack = (u8*)mem;
+        stack_size = total;
+        tid = (u32*)end;
+        __atomic_add_fetch(&detail::shared_tls_threads, 1, __ATOMIC_ACQ_REL);
+        #ifdef RAZ_CHECK_THREADS
+        detail::register_stack(stack, stack_size);
+        #endif
+        if(sys::clone_thread(&entry<F>, slot, (void*)top, tid) < 0) {
+            slot->~F();
+            *tid = 0;
+            release();
         }
-        return optional<V>();
+        #else
+        (void)size;
+        fn();
+        #endif
     }
 
-    bool contains(const K& key) const {
-        for(u32 i = 0; i < len; i++) {
-            if(data[i].first == key) return true;
+    thread(const thread&) = delete;
+    thread& operator=(const thread&) = delete;
+
+    thread(thread&& other) : stack(other.stack), stack_size(other.stack_size), tid(other.tid) {
+        other.stack = nullptr;
+        other.tid = nullptr;
+    }
+
+    thread& operator=(thread&& other) {
+        if(this != &other) {
+            join();
+            stack = other.stack;
+            stack_size = other.stack_size;
+            tid = other.tid;
+            other.stack = nullptr;
+            other.tid = nullptr;
         }
-        return false;
+        return *this;
     }
 
-    u32 size() const { return len; }
-    bool empty() const { return len == 0; }
+    ~thread() { join(); }
 
-    void erase(const K& key) {
-        for(u32 i = 0; i < len; i++) {
-            if(data[i].first == key) {
-                for(u32 j = i; j < len - 1; j++) {
-                    data[j] = data[j + 1];
-                }
-                len--;
-                return;
-            }
+    bool joinable() const { return stack != nullptr; }
+    // The kernel tid, 0 once the thread has exited.
+    u32 id() const { return stack ? __atomic_load_n(tid, __ATOMIC_ACQUIRE) : 0; }
+
+    // True when `p` lies on this thread's stack, which is how the pool tells
+    // its workers apart without thread-local storage.
+    bool on_stack(const void* p) const {
+        return stack && (const u8*)p >= stack && (const u8*)p < stack + stack_size;
+    }
+
+    // Waits on the tid word the kernel clears and wakes at thread exit.
+    void join() {
+        if(!stack) return;
+        while(true) {
+            u32 t = __atomic_load_n(tid, __ATOMIC_ACQUIRE);
+            if(t == 0) break;
+            sys::futex_wait(tid, t, true);
         }
+        release();
     }
 };
 
-template<typename T>
-class array {
-private:
-    T* data;
-    u32 len;
+u32 hardware_concurrency() {
+    #if RAZ_HAS_THREADS
+    return sys::cpu_count();
+    #else
+    return 1;
+    #endif
+}
 
-public:
-    array(u32 size) : data(new T[size]), len(size) {}
-    
-    array(std::initializer_list<T> init_list) : data(new T[init_list.size()]), len(init_list.size()) {
-        u32 i = 0;
-        for(const T& item : init_list) {
-            data[i++] = item;
+namespace detail {
+
+struct pool_task {
+    void (*run)(pool_task*);
+    u32 done;
+};
+
+template<typename F>
+struct fn_task : pool_task {
+    F* fn;
+
+    explicit fn_task(F& f) : fn(&f) {
+        run = &invoke;
+        done = 0;
+    }
+
+    static void invoke(pool_task* t) { (*((fn_task*)t)->fn)(); }
+};
+
+// Chase-Lev work-stealing deque over a fixed ring, with the C11 orderings of
+// Le et al. The owner pushes and pops at the bottom; thieves take the top.
+struct steal_deque {
+    alignas(RAZ_CACHE_LINE) i64 top;
+    alignas(RAZ_CACHE_LINE) i64 bottom;
+    pool_task* ring[RAZ_POOL_DEQUE_SIZE];
+
+    static constexpr i64 mask = RAZ_POOL_DEQUE_SIZE - 1;
+
+    steal_deque() : top(0), bottom(0) {}
+
+    bool push(pool_task* t) {
+        i64 b = __atomic_load_n(&bottom, __ATOMIC_RELAXED);
+        i64 tp = __atomic_load_n(&top, __ATOMIC_ACQUIRE);
+        if(b - tp >= RAZ_POOL_DEQUE_SIZE) return false;
+        __atomic_store_n(&ring[b & mask], t, __ATOMIC_RELAXED);
+        __atomic_store_n(&bottom, b + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    pool_task* pop() {
+        i64 b = __atomic_load_n(&bottom, __ATOMIC_RELAXED) - 1;
+        __atomic_store_n(&bottom, b, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        i64 tp = __atomic_load_n(&top, __ATOMIC_RELAXED);
+        if(tp > b) {
+            __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
+            return nullptr;
+        }
+        pool_task* t = __atomic_load_n(&ring[b & mask], __ATOMIC_RELAXED);
+        if(tp == b) {
+            if(!__atomic_compare_exchange_n(&top, &tp, tp + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) t = nullptr;
+            __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
         }
+        return t;
     }
 
-    ~array() {
-        delete[] data;
+    pool_task* steal() {
+        i64 tp = __atomic_load_n(&top, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        i64 b = __atomic_load_n(&bottom, __ATOMIC_ACQUIRE);
+        if(tp >= b) return nullptr;
+        pool_task* t = __atomic_load_n(&ring[tp & mask], __ATOMIC_RELAXED);
+        if(!__atomic_compare_exchange_n(&top, &tp, tp + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) return nullptr;
+        return t;
     }
 
-    T& operator[](u32 index) { return data[index]; }
-    const T& operator[](u32 index) const { return data[index]; }
-    
-    u32 size() const { return len; }
-    T* begin() { return data; }
-    T* end() { return data + len; }
-    const T* begin() const { return data; }
-    const T* end() const { return data + len; }
+    bool looks_empty() const {
+        return __atomic_load_n(&top, __ATOMIC_ACQUIRE) >= __atomic_load_n(&bottom, __ATOMIC_ACQUIRE);
+    }
 };
 
-template<typename T>
-class vector {
+}
+
+// Work-stealing pool. Worker 0 is whichever thread calls into the pool from
+// outside; the others are raz::threads that sleep on a futex when there is
+// nothing to steal. Work is forked with invoke(a, b): b is offered to thieves
+// while the caller runs a, then the caller helps until b is done. One outside
+// thread may drive a pool at a time; bodies may fork again.
+class thread_pool {
 private:
-    T* data;
-    u32 len;
-    u32 cap;
+    struct worker {
+        detail::steal_deque deque;
+        thread handle;
+        u64 rng;
+    };
 
-    void resize(u32 new_cap) {
-        T* new_data = new T[new_cap];
-        for(u32 i = 0; i < len; i++) {
-            new_data[i] = data[i];
+    worker* workers;
+    u32 count;
+    u64 map_size;
+    alignas(RAZ_CACHE_LINE) u32 epoch;
+    u32 sleepers;
+    u32 ready;
+    u32 stop;
+
+    u32 current_index() const {
+        const void* sp = __builtin_frame_address(0);
+        for(u32 i = 1; i < count; i++) {
+            if(workers[i].handle.on_stack(sp)) return i;
         }
-        delete[] data;
-        data = new_data;
-        cap = new_cap;
+        return 0;
     }
 
-public:
-    vector() : data(new T[8]), len(0), cap(8) {}
-    
-    vector(u32 size) : data(new T[size]), len(size), cap(size) {}
-    
-    vector(const vector& other) : len(other.len), cap(other.cap) {
-        data = new T[cap];
-        for(u32 i = 0; i < len; i++) {
-            data[i] = other.data[i];
+    detail::pool_task* steal(u32 id) {
+        u64& r = workers[id].rng;
+        r ^= r << 13;
+        r ^= r >> 7;
+        r ^= r << 17;
+        u32 start = (u32)(r % count);
+        for(u32 k = 0; k < count; k++) {
+            u32 victim = start + k < count ? start + k : start + k - count;
+            if(victim == id) continue;
+            detail::pool_task* t = workers[victim].deque.steal();
+            if(t) return t;
         }
+        return nullptr;
     }
 
-    vector(std::initializer_list<T> init_list) : len(init_list.size()), cap(init_list.size()) {
-        data = new T[cap];
-        u32 i = 0;
-        for(const T& item : init_list) {
-            data[i++] = item;
+    detail::pool_task* find_task(u32 id) {
+        detail::pool_task* t = workers[id].deque.pop();
+        return t ? t : steal(id);
+    }
+
+    bool has_work() const {
+        for(u32 i = 0; i < count; i++) {
+            if(!workers[i].deque.looks_empty()) return true;
         }
+        return false;
     }
 
-    ~vector() {
-        delete[] data;
+    static void execute(detail::pool_task* t) {
+        t->run(t);
+        __atomic_store_n(&t->done, 1, __ATOMIC_RELEASE);
     }
 
-    void push_back(const T& value) {
-        if(len >= cap) resize(cap * 2);
-        data[len++] = value;
+    // Pairs with the sleeper's increment of `sleepers` and re-check in run():
+    // either the sleeper sees the new task or this sees the sleeper.
+    void notify() {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if(__atomic_load_n(&sleepers, __ATOMIC_RELAXED) == 0) return;
+        __atomic_add_fetch(&epoch, 1, __ATOMIC_RELEASE);
+        sys::futex_wake(&epoch, 1);
     }
 
-    void pop_back() {
-        if(len > 0) len--;
+    void wait_for(u32 id, detail::pool_task* t) {
+        u32 idle = 0;
+        while(!__atomic_load_n(&t->done, __ATOMIC_ACQUIRE)) {
+            detail::pool_task* next = find_task(id);
+            if(next) {
+                execute(next);
+                idle = 0;
+            } else if(++idle < 64) {
+                detail::cpu_relax();
+            } else {
+                sys::sched_yield();
+            }
+        }
     }
 
-    T& operator[](u32 index) { return data[index]; }
-    const T& operator[](u32 index) const { return data[index]; }
+    void run(u32 id) {
+        while(!__atomic_load_n(&ready, __ATOMIC_ACQUIRE)) sys::futex_wait(&ready, 0);
+        u32 idle = 0;
+        while(!__atomic_load_n(&stop, __ATOMIC_ACQUIRE)) {
+            detail::pool_task* t = find_task(id);
+            if(t) {
+                execute(t);
+                idle = 0;
+                continue;
+            }
+            if(++idle < 64) {
+                detail::cpu_relax();
+                continue;
+            }
+            if(idle < 72) {
+                sys::sched_yield();
+                continue;
+            }
+            u32 e = __atomic_load_n(&epoch, __ATOMIC_ACQUIRE);
+            __atomic_add_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+            if(!has_work() && !__atomic_load_n(&stop, __ATOMIC_ACQUIRE)) sys::futex_wait(&epoch, e);
+            __atomic_sub_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+            idle = 0;
+        }
+    }
 
-    u32 size() const { return len; }
-    u32 capacity() const { return cap; }
-    bool empty() const { return len == 0; }
+public:
+    // `threads` counts the calling thread; 0 means one per available CPU.
+    explicit thread_pool(u32 threads = 0) : epoch(0), sleepers(0), ready(0), stop(0) {
+        count = threads ? threads : hardware_concurrency();
+        #if !RAZ_HAS_THREADS
+        count = 1;
+        #endif
+        map_size = align_up(sizeof(worker) * count, 4096);
+        workers = (worker*)sys::mmap(nullptr, map_size, sys::prot_read | sys::prot_write,
+                                     sys::map_private | sys::map_anonymous);
+        // Without the mapping the pool runs everything on the caller; with a
+        // single worker invoke() never touches a deque, so none is needed.
+        if(!workers) count = 1;
+        for(u32 i = 0; workers && i < count; i++) {
+            new (&workers[i]) worker();
+            workers[i].rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+        }
+        for(u32 i = 1; workers && i < count; i++) workers[i].handle = thread([this, i] { run(i); });
+        __atomic_store_n(&ready, 1, __ATOMIC_RELEASE);
+        sys::futex_wake(&ready, (i32)count);
+    }
 
-    T* begin() { return data; }
-    T* end() { return data + len; }
-    const T* begin() const { return data; }
-    const T* end() const { return data + len; }
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
 
-    void clear() { len = 0; }
-    
-    T& front() { return data[0]; }
-    T& back() { return data[len - 1]; }
-    const T& front() const { return data[0]; }
-    const T& back() const { return data[len - 1]; }
-};
+    ~thread_pool() {
+        __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&epoch, 1, __ATOMIC_RELEASE);
+        sys::futex_wake(&epoch, (i32)count);
+        if(!workers) return;
+        for(u32 i = 0; i < count; i++) workers[i].~worker();
+        sys::munmap(workers, map_size);
+    }
 
-i32 abs(i32 x) { return x < 0 ? -x : x; }
-f64 abs(f64 x) { return x < 0 ? -x : x; }
+    u32 size() const { return count; }
 
-f64 pow(f64 base, i32 exp) {
-    f64 result = 1.0;
-    bool negative = exp < 0;
-    u32 abs_exp = negative ? -exp : exp;
-    
-    for(u32 i = 0; i < abs_exp; i++) result *= base;
-    return negative ? 1.0 / result : result;
+    // Runs a() and b(), possibly in parallel, and returns when both are done.
+    template<typename F1, typename F2>
+    void invoke(F1&& a, F2&& b) {
+        u32 id = current_index();
+        detail::fn_task<typename remove_reference<F2>::type> task(b);
+        if(count == 1 || !workers[id].deque.push(&task)) {
+            a();
+            b();
+            return;
+        }
+        notify();
+        a();
+        wait_for(id, &task);
+    }
+};
+
+thread_pool& default_pool() {
+    static thread_pool pool;
+    return pool;
 }
 
-i32 min(i32 a, i32 b) { return a < b ? a : b; }
-i32 max(i32 a, i32 b) { return a > b ? a : b; }
-f64 min(f64 a, f64 b) { return a < b ? a : b; }
-f64 max(f64 a, f64 b) { return a > b ? a : b; }
+namespace detail {
 
-template<typename T>
-void swap(T& a, T& b) {
-    T temp = a;
-    a = b;
-    b = temp;
+inline u32 parallel_grain(thread_pool& pool, u32 n, u32 grain) {
+    if(grain) return grain;
+    grain = n / (pool.size() * 8);
+    return grain ? grain : 1;
 }
 
-template<typename T>
-void sort(T* arr, u32 size) {
-    for(u32 i = 0; i < size - 1; i++) {
-        for(u32 j = 0; j < size - i - 1; j++) {
-            if(arr[j] > arr[j + 1]) swap(arr[j], arr[j + 1]);
-        }
+template<typename F>
+void parallel_chunks(thread_pool& pool, u32 lo, u32 hi, u32 grain, F& body) {
+    if(hi - lo <= grain) {
+        body(lo, hi);
+        return;
     }
+    u32 mid = lo + (hi - lo) / 2;
+    pool.invoke([&] { parallel_chunks(pool, lo, mid, grain, body); },
+                [&] { parallel_chunks(pool, mid, hi, grain, body); });
 }
 
-template<typename T>
-i32 find(const T* arr, u32 size, const T& value)
-{
-    for(u32 i = 0; i < size; i++) 
-    {
-        if(arr[i] == value) return i;
+template<typename T, typename M, typename R>
+T parallel_fold(thread_pool& pool, u32 lo, u32 hi, u32 grain, const T& init, M& map, R& reduce) {
+    if(hi - lo <= grain) {
+        T acc = init;
+        for(u32 i = lo; i < hi; i++) acc = reduce(acc, map(i));
+        return acc;
     }
-    return -1;
+    u32 mid = lo + (hi - lo) / 2;
+    T left = init;
+    T right = init;
+    pool.invoke([&] { left = parallel_fold(pool, lo, mid, grain, init, map, reduce); },
+                [&] { right = parallel_fold(pool, mid, hi, grain, init, map, reduce); });
+    return reduce(left, right);
 }
 
-class random {
-private:
-    u32 seed;
-
-public:
-    random(u32 initial_seed = 12345) : seed(initial_seed) {}
-    
-    
+static constexpr u32 parallel_merge_grain = 4096;
 
-    u32 next()
-    {
-        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
-        return seed;
+// Merges a[0, na) and b[0, nb) into out, splitting around the median of the
+// longer run so both halves can proceed in parallel.
+template<typename T, typename C>
+void parallel_merge(thread_pool& pool, T* a, u32 na, T* b, u32 nb, T* out, C& comp) {
+    if(na + nb <= parallel_merge_grain) {
+        u32 i = 0, j = 0, k = 0;
+        while(i < na && j < nb) {
+            if(comp(b[j], a[i])) out[k++] = move(b[j++]);
+            else out[k++] = move(a[i++]);
+        }
+        while(i < na) out[k++] = move(a[i++]);
+        while(j < nb) out[k++] = move(b[j++]);
+        return;
     }
-    
-    u32 range(u32 min, u32 max) 
-    {
-        return min + (next() % (max - min + 1));
+    u32 ma, mb;
+    if(na >= nb) {
+        ma = na / 2;
+        u32 lo = 0, hi = nb;
+        while(lo < hi) {
+            u32 mid = (lo + hi) / 2;
+            if(comp(b[mid], a[ma])) lo = mid + 1;
+            else hi = mid;
+        }
+        mb = lo;
+        out[ma + mb] = move(a[ma]);
+        pool.invoke([&] { parallel_merge(pool, a, ma, b, mb, out, comp); },
+                    [&] { parallel_merge(pool, a + ma + 1, na - ma - 1, b + mb, nb - mb, out + ma + mb + 1, comp); });
+    } else {
+        mb = nb / 2;
+        u32 lo = 0, hi = na;
+        while(lo < hi) {
+            u32 mid = (lo + hi) / 2;
+            if(comp(b[mb], a[mid])) hi = mid;
+            else lo = mid + 1;
+        }
+        ma = lo;
+        out[ma + mb] = move(b[mb]);
+        pool.invoke([&] { parallel_merge(pool, a, ma, b, mb, out, comp); },
+                    [&] { parallel_merge(pool, a + ma, na - ma, b + mb + 1, nb - mb - 1, out + ma + mb + 1, comp); });
     }
-    
-    f64 float_range(f64 min, f64 max) 
-    {
-        return min + (next() / (f64)0x7FFFFFFF) * (max - min);
+}
+
+// Sorts src[0, n) and leaves the result in src, or in dst when `into_dst`.
+// The halves are sorted into the other array so every merge moves forward.
+template<typename T, typename C>
+void parallel_sort_into(thread_pool& pool, T* src, T* dst, u32 n, u32 grain, bool into_dst, C& comp) {
+    if(n <= grain) {
+        sort(src, n, comp);
+        if(into_dst) {
+            for(u32 i = 0; i < n; i++) dst[i] = move(src[i]);
+        }
+        return;
     }
-};
+    u32 mid = n / 2;
+    pool.invoke([&] { parallel_sort_into(pool, src, dst, mid, grain, !into_dst, comp); },
+                [&] { parallel_sort_into(pool, src + mid, dst + mid, n - mid, grain, !into_dst, comp); });
+    T* from = into_dst ? src : dst;
+    T* to = into_dst ? dst : src;
+    parallel_merge(pool, from, mid, from + mid, n - mid, to, comp);
+}
 
-template<typename T>
-class queue {
-private:
-    vector<T> data;
+}
 
-public:
-    void push(const T& value) { data.push_back(value); }
-    void pop() 
-    { 
-        if(!data.empty()) {
-            for(u32 i = 1; i < data.size(); i++) {
-                data[i-1] = data[i];
-            }
-            data.pop_back();
-        }
+template<typename F>
+void parallel_for(thread_pool& pool, u32 begin, u32 end, F body, u32 grain = 0) {
+    if(begin >= end) return;
+    auto chunk = [&](u32 lo, u32 hi) {
+        for(u32 i = lo; i < hi; i++) body(i);
+    };
+    detail::parallel_chunks(pool, begin, end, detail::parallel_grain(pool, end - begin, grain), chunk);
+}
+
+template<typename T, typename A, typename F>
+void parallel_for(thread_pool& pool, vector<T, A>& v, F body) {
+    T* data = v.begin();
+    parallel_for(pool, 0, v.size(), [&](u32 i) { body(data[i]); });
+}
+
+template<typename T, typename A, typename F>
+void parallel_for(thread_pool& pool, array<T, A>& arr, F body) {
+    T* data = arr.begin();
+    parallel_for(pool, 0, arr.size(), [&](u32 i) { body(data[i]); });
+}
+
+// `init` must be an identity for `reduce`: every chunk starts from it.
+template<typename T, typename M, typename R>
+T parallel_reduce(thread_pool& pool, u32 begin, u32 end, T init, M map, R reduce, u32 grain = 0) {
+    if(begin >= end) return init;
+    return detail::parallel_fold(pool, begin, end, detail::parallel_grain(pool, end - begin, grain), init, map, reduce);
+}
+
+template<typename T, typename A, typename R>
+T parallel_reduce(thread_pool& pool, const vector<T, A>& v, T init, R reduce) {
+    const T* data = v.begin();
+    return parallel_reduce(pool, 0, v.size(), init, [&](u32 i) -> const T& { return data[i]; }, reduce);
+}
+
+template<typename T, typename A, typename R>
+T parallel_reduce(thread_pool& pool, const array<T, A>& arr, T init, R reduce) {
+    const T* data = arr.begin();
+    return parallel_reduce(pool, 0, arr.size(), init, [&](u32 i) -> const T& { return data[i]; }, reduce);
+}
+
+// Parallel merge sort with pdqsort leaves; like sort() it is not stable.
+// Needs one temporary of `size` elements.
+template<typename T, typename C>
+void parallel_sort(thread_pool& pool, T* arr, u32 size, C comp) {
+    static constexpr u32 min_parallel = 1u << 14;
+    if(pool.size() == 1 || size < min_parallel) {
+        sort(arr, size, comp);
+        return;
     }
-    T& front() { return data[0]; }
-    const T& front() const { return data[0]; }
-    bool empty() const { return data.empty(); }
-    u32 size() const { return data.size(); }
-};
+    T* buffer = (T*)detail::heap_alloc(sizeof(T) * size);
+    parallel_for(pool, 0, size, [&](u32 i) { new (&buffer[i]) T(move(arr[i])); }, detail::parallel_merge_grain);
+    u32 grain = size / (pool.size() * 4);
+    if(grain < detail::parallel_merge_grain) grain = detail::parallel_merge_grain;
+    detail::parallel_sort_into(pool, buffer, arr, size, grain, true, comp);
+    if(!is_trivially_copyable<T>::value) {
+        for(u32 i = 0; i < size; i++) buffer[i].~T();
+    }
+    detail::heap_free(buffer);
+}
 
 template<typename T>
-class stack {
-private:
-    vector<T> data;
+void parallel_sort(thread_pool& pool, T* arr, u32 size) {
+    parallel_sort(pool, arr, size, less());
+}
 
+template<typename T, typename A> void parallel_sort(thread_pool& pool, vector<T, A>& v) { parallel_sort(pool, v.begin(), v.size()); }
+template<typename T, typename A, typename C> void parallel_sort(thread_pool& pool, vector<T, A>& v, C comp) { parallel_sort(pool, v.begin(), v.size(), comp); }
+template<typename T, typename A> void parallel_sort(thread_pool& pool, array<T, A>& arr) { parallel_sort(pool, arr.begin(), arr.size()); }
+template<typename T, typename A, typename C> void parallel_sort(thread_pool& pool, array<T, A>& arr, C comp) { parallel_sort(pool, arr.begin(), arr.size(), comp); }
 
+template<typename F> void parallel_for(u32 begin, u32 end, F body, u32 grain = 0) { parallel_for(default_pool(), begin, end, body, grain); }
+template<typename T, typename A, typename F> void parallel_for(vector<T, A>& v, F body) { parallel_for(default_pool(), v, body); }
+template<typename T, typename A, typename F> void parallel_for(array<T, A>& arr, F body) { parallel_for(default_pool(), arr, body); }
+template<typename T, typename M, typename R> T parallel_reduce(u32 begin, u32 end, T init, M map, R reduce, u32 grain = 0) { return parallel_reduce(default_pool(), begin, end, init, map, reduce, grain); }
+template<typename T, typename A, typename R> T parallel_reduce(const vector<T, A>& v, T init, R reduce) { return parallel_reduce(default_pool(), v, init, reduce); }
+template<typename T, typename A, typename R> T parallel_reduce(const array<T, A>& arr, T init, R reduce) { return parallel_reduce(default_pool(), arr, init, reduce); }
+template<typename T, typename A> void parallel_sort(vector<T, A>& v) { parallel_sort(default_pool(), v); }
+template<typename T, typename A, typename C> void parallel_sort(vector<T, A>& v, C comp) { parallel_sort(default_pool(), v, comp); }
+template<typename T, typename A> void parallel_sort(array<T, A>& arr) { parallel_sort(default_pool(), arr); }
+template<typename T, typename A, typename C> void parallel_sort(array<T, A>& arr, C comp) { parallel_sort(default_pool(), arr, comp); }
 
+u32 hash_simple(const char* str) {
+    return (u32)hash_bytes(str, strlen_simple(str));
+}
 
-public:
-    void push(const T& value) { data.push_back(value); }
-    void pop() { if(!data.empty()) data.pop_back(); }
-    T& top() { return data.back(); }
-    const T& top() const { return data.back(); }
-    bool empty() const { return data.empty(); }
-    u32 size() const { return data.size(); }
-};
+}
 
-u32 hash_simple
-(const char* str) 
-{
-    u32 hash = 5381;
-    u32 i = 0;
-    while(str[i] != '\0') {
-        hash = ((hash << 5) + hash) + str[i];
-        i++;
-    }
-    return hash;
+#ifdef RAZ_CHECK_THREADS
+// raz::threads share their creator's TLS and with it libc's malloc caches, so
+// the global new and delete trap when called on one.
+void* operator new(decltype(sizeof(0)) size) {
+    if(raz::detail::on_thread_stack()) __builtin_trap();
+    void* ptr = __builtin_malloc(size ? size : 1);
+    if(!ptr) __builtin_trap();
+    return ptr;
 }
 
+void* operator new[](decltype(sizeof(0)) size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept {
+    if(ptr && raz::detail::on_thread_stack()) __builtin_trap();
+    __builtin_free(ptr);
 }
 
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, decltype(sizeof(0))) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, decltype(sizeof(0))) noexcept { operator delete(ptr); }
+#endif
+
 #define let auto
 #define var auto
 #define loop for(;;)